@@ -0,0 +1,234 @@
+/**
+* @copyright 2025 - Max Bebök
+* @license MIT
+*/
+#include "bench.h"
+#include "main.h"
+#include "math.h"
+#include "text.h"
+#include "miMemory.h"
+#include "spanRaster.h"
+#include "rdp/rdp.h"
+#include "rdp/dpl.h"
+#include <array>
+
+namespace
+{
+  constexpr uint32_t DPL_SIZE = 64;
+  constinit volatile uint64_t sinkValue{};
+
+  constexpr RDP::Vertex TRI_VERTS[3]{
+    {.pos = {40.5f, 20.25f}, .color = {1.0f, 0.5f, 0.25f, 1.0f}},
+    {.pos = {20.0f, 100.75f}, .color = {0.25f, 1.0f, 0.5f, 1.0f}},
+    {.pos = {150.25f, 60.5f}, .color = {0.5f, 0.25f, 1.0f, 1.0f}},
+  };
+
+  void runTriangleGen(uint32_t count)
+  {
+    auto v0 = TRI_VERTS[0];
+    for(uint32_t i=0; i<count; ++i) {
+      v0.pos[0] = TRI_VERTS[0].pos[0] + (i & 7);
+      auto p = RDP::triangleGen(RDP::TriAttr::SHADE, v0, TRI_VERTS[1], TRI_VERTS[2]);
+      Bench::sink(p.lft ^ p.y1f);
+    }
+  }
+
+  void runTriangleWrite(uint32_t count)
+  {
+    auto p = RDP::triangleGen(RDP::TriAttr::SHADE, TRI_VERTS[0], TRI_VERTS[1], TRI_VERTS[2]);
+    for(uint32_t i=0; i<count; ++i) {
+      auto cmds = RDP::triangleWrite(p, RDP::TriAttr::SHADE);
+      Bench::sink(cmds[1]);
+    }
+  }
+
+  void runFillRectEncode(uint32_t count)
+  {
+    for(uint32_t i=0; i<count; ++i) {
+      uint8_t c = i;
+      Bench::sink(RDP::setFillColor({c, c, c, 0xFF}) ^ RDP::fillRect(i & 63, 8, 100, 100));
+    }
+  }
+
+  void runDPLAdd(uint32_t count)
+  {
+    static RDP::DPL dpl{DPL_SIZE};
+    dpl.reset();
+    for(uint32_t i=0; i<count; ++i) {
+      if((i % DPL_SIZE) == 0)dpl.reset();
+      dpl.add(RDP::syncPipe());
+    }
+    Bench::sink(dpl.dplEnd - dpl.dpl);
+  }
+
+  void runTextPrint(uint32_t count)
+  {
+    for(uint32_t i=0; i<count; ++i) {
+      Bench::sink(Text::print(16, 32 + (i & 7) * 8, "Bench: 0123456789"));
+    }
+  }
+
+  void runTextPrintf(uint32_t count)
+  {
+    for(uint32_t i=0; i<count; ++i) {
+      Bench::sink(Text::printf(16, 32 + (i & 7) * 8, "%.2fms %03X", i * 0.01f, i & 0xFFF));
+    }
+  }
+
+  void runTextPrintFmt(uint32_t count)
+  {
+    for(uint32_t i=0; i<count; ++i) {
+      Bench::sink(Text::printFmt(16, 32 + (i & 7) * 8, "%.2fms %03X", i * 0.01f, i & 0xFFF));
+    }
+  }
+
+  void runBatchPrint(uint32_t count)
+  {
+    constexpr uint32_t GLYPHS = 17;
+    static RDP::DPL dpl{Text::Batch::SETUP_CMDS + GLYPHS * Text::Batch::GLYPH_CMDS};
+    for(uint32_t i=0; i<count; ++i) {
+      dpl.reset();
+      Text::Batch::begin(dpl);
+      Text::Batch::print(dpl, 16, 32 + (i & 7) * 8, "Bench: 0123456789");
+      Bench::sink(dpl.dplEnd - dpl.dpl);
+    }
+  }
+
+  // frame-time overlay with one changing digit, redrawn into the same buffer
+  void runLayerDraw(uint32_t count)
+  {
+    constexpr const char* TEXTS[2]{"16.62ms", "16.63ms"};
+    auto handle = Text::Layer::create();
+    for(uint32_t i=0; i<count; ++i) {
+      Text::Layer::print(handle, 16, 32, TEXTS[i & 1]);
+      Bench::sink(Text::Layer::draw());
+    }
+    Text::Layer::remove(handle);
+    Text::Layer::draw();
+  }
+
+  void runPrintLarge(uint32_t count)
+  {
+    for(uint32_t i=0; i<count; ++i) {
+      Bench::sink(Text::printLarge(16, 96, "Rep64", {.color = 0x1234'1234'1234'1234}));
+    }
+  }
+
+  // full framebuffer clear (incl. stride padding) as done on demo switches
+  void runClearMemset(uint32_t count)
+  {
+    for(uint32_t i=0; i<count; ++i) {
+      memset(state.fb->buffer, 0, state.fb->height * state.fb->stride);
+    }
+  }
+
+  void runClearFillRect(uint32_t count)
+  {
+    auto fb = surface_make(state.fb->buffer, FMT_RGBA16, state.fb->stride/2, state.fb->height, state.fb->stride);
+    for(uint32_t i=0; i<count; ++i) {
+      MiMem::fillRect(fb, 0, 0, fb.width, fb.height, 0);
+    }
+  }
+
+  // same hexagon (~120x100px) with MI-repeat spans, per-pixel CPU stores and RDP triangles
+  constexpr SpanRaster::Point HEXAGON[6]{
+    {130.0f, 70.5f}, {200.25f, 70.5f}, {240.0f, 120.0f}, {200.25f, 170.5f}, {130.0f, 170.5f}, {100.0f, 120.0f}
+  };
+  constexpr uint16_t HEXAGON_COLOR = 0x7BDF;
+
+  void runSpanMI(uint32_t count)
+  {
+    for(uint32_t i=0; i<count; ++i) {
+      SpanRaster::fillConvex(*state.fb, HEXAGON, 6, HEXAGON_COLOR);
+    }
+  }
+
+  void runSpanCPU(uint32_t count)
+  {
+    static SpanRaster::Span spans[SpanRaster::MAX_ROWS];
+    for(uint32_t i=0; i<count; ++i) {
+      int firstRow;
+      int rows = SpanRaster::convexSpans(HEXAGON, 6, state.fb->height, spans, firstRow);
+      auto row = (uint8_t*)state.fb->buffer + firstRow * state.fb->stride;
+      for(int r=0; r<rows; ++r, row += state.fb->stride) {
+        for(int x=spans[r].x0; x<spans[r].x1; ++x)((volatile uint16_t*)row)[x] = HEXAGON_COLOR;
+      }
+    }
+  }
+
+  void runSpanRDP(uint32_t count)
+  {
+    static RDP::DPL dpl{32};
+    for(uint32_t i=0; i<count; ++i) {
+      dpl.reset();
+      dpl.add(RDP::syncPipe())
+        .add(RDP::setColorImage(state.fb->buffer, RDP::Format::RGBA, RDP::BBP::_16, state.fb->stride/2))
+        .add(RDP::setScissor(0, 0, state.fb->width-1, state.fb->height-1))
+        .add(RDP::setOtherModes(RDP::OtherMode().cycleType(RDP::CYCLE::ONE)))
+        .add(RDP::setCC1Cycle({
+          RDP::CC::C_A::ZERO, RDP::CC::C_B::ZERO, RDP::CC::C_C::ZERO, RDP::CC::C_D::PRIM,
+          RDP::CC::A_ABD::ZERO, RDP::CC::A_ABD::ZERO, RDP::CC::A_C::ZERO, RDP::CC::A_ABD::ONE
+        }))
+        .add(RDP::setPrimColor({0x78, 0x78, 0xF8, 0xFF}));
+
+      // fan around the first vertex
+      for(int t=1; t<5; ++t) {
+        dpl.add(RDP::triangle(0,
+          {.pos = {HEXAGON[0].x, HEXAGON[0].y}},
+          {.pos = {HEXAGON[t].x, HEXAGON[t].y}},
+          {.pos = {HEXAGON[t+1].x, HEXAGON[t+1].y}}
+        ));
+      }
+      dpl.runSync();
+    }
+  }
+
+  void runSinApprox(uint32_t count)
+  {
+    float sum = 0;
+    for(uint32_t i=0; i<count; ++i) {
+      sum += Math::sinApprox(i * 0.01f);
+    }
+    Bench::sink((uint64_t)(int64_t)sum);
+  }
+
+  void runSinBatch(uint32_t count)
+  {
+    constexpr uint32_t LINES = 240;
+    static float out[LINES];
+    for(uint32_t i=0; i<count; i+=LINES) {
+      Math::sinBatch(out, i * 0.01f, 0.03f, count - i < LINES ? count - i : LINES);
+      Bench::sink((uint64_t)(int64_t)(out[0] * 1000.0f));
+    }
+  }
+
+  constexpr auto KERNELS = std::to_array<Bench::Kernel>({
+    {"triangleGen",      200, runTriangleGen},
+    {"triangleWrite",    200, runTriangleWrite},
+    {"fillColor+Rect",  1000, runFillRectEncode},
+    {"DPL::add",        1000, runDPLAdd},
+    {"Text::print 17ch",  50, runTextPrint},
+    {"printf %f %X",      50, runTextPrintf},
+    {"printFmt %f %X",    50, runTextPrintFmt},
+    {"Batch::print 17ch", 50, runBatchPrint},
+    {"Layer::draw 1/7ch", 50, runLayerDraw},
+    {"printLarge 5ch",    10, runPrintLarge},
+    {"clear memset",       2, runClearMemset},
+    {"clear fillRect",     2, runClearFillRect},
+    {"hexagon MI spans",  10, runSpanMI},
+    {"hexagon CPU store", 10, runSpanCPU},
+    {"hexagon RDP tris",  10, runSpanRDP},
+    {"Math::sinApprox", 1000, runSinApprox},
+    {"Math::sinBatch",  1000, runSinBatch},
+  });
+}
+
+std::span<const Bench::Kernel> Bench::kernels()
+{
+  return KERNELS;
+}
+
+void Bench::sink(uint64_t value)
+{
+  sinkValue = sinkValue + value;
+}
@@ -0,0 +1,27 @@
+/**
+* @copyright 2025 - Max Bebök
+* @license MIT
+*/
+#pragma once
+#include <libdragon.h>
+#include <span>
+
+/**
+ * CPU micro-benchmarks of the hot code paths (command encoding, DPL, text, math).
+ * Shared by the on-ROM 'Benchmark' demo (ticks/op) and tools/host/hostBench (ns/op, allocs/op),
+ * so both measure the exact same work.
+ */
+namespace Bench
+{
+  struct Kernel {
+    const char* name;
+    // default iterations per measurement, keeps a single run well within a frame on console
+    uint32_t iterations;
+    void (*run)(uint32_t count);
+  };
+
+  std::span<const Kernel> kernels();
+
+  // consumes results, so the compiler can't drop the measured work
+  void sink(uint64_t value);
+}
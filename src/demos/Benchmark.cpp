@@ -0,0 +1,107 @@
+/**
+* @copyright 2025 - Max Bebök
+* @license MIT
+*/
+#include "../main.h"
+#include "../bench.h"
+#include "../text.h"
+#include "../rdp/rdp.h"
+#include "../rdp/dpl.h"
+
+#include <vector>
+
+namespace
+{
+  struct Result {
+    float ticksPerOp{};
+    uint32_t iterations{};
+  };
+
+  constinit bool needsRun{};
+  std::vector<Result> results{};
+
+  void runAll()
+  {
+    auto kernels = Bench::kernels();
+    results.assign(kernels.size(), {});
+
+    disable_interrupts();
+    for(uint32_t k=0; k<kernels.size(); ++k)
+    {
+      auto &kernel = kernels[k];
+      kernel.run(1); // warm-up, first call may set up buffers
+
+      uint64_t start = get_ticks();
+      kernel.run(kernel.iterations);
+      uint64_t ticks = get_ticks() - start;
+
+      results[k] = {
+        .ticksPerOp = (float)ticks / kernel.iterations,
+        .iterations = kernel.iterations,
+      };
+    }
+    enable_interrupts();
+
+    for(uint32_t k=0; k<kernels.size(); ++k) {
+      debugf("{\"bench\":\"%s\",\"ticks_per_op\":%.2f,\"iterations\":%lu}\n",
+        kernels[k].name, results[k].ticksPerOp, results[k].iterations
+      );
+    }
+  }
+}
+
+namespace Demo::Benchmark
+{
+  extern const char* const name = "CPU Benchmark";
+
+  void init() {
+    needsRun = true;
+  }
+
+  void destroy() {
+    results.clear();
+  }
+
+  void draw()
+  {
+    auto pressed = joypad_get_buttons_pressed(JOYPAD_PORT_1);
+    if(pressed.a)needsRun = true;
+
+    // kernels draw text into the framebuffer, so they run before the clear
+    if(needsRun) {
+      runAll();
+      needsRun = false;
+    }
+
+    RDP::DPL dpl{8};
+    dpl.add(RDP::syncPipe())
+      .add(RDP::setColorImage(state.fb->buffer, RDP::Format::RGBA, RDP::BBP::_16, state.fb->stride/2))
+      .add(RDP::setScissor(0, 0, state.fb->width-1, state.fb->height-1))
+      .add(RDP::setOtherModes(RDP::OtherMode().cycleType(RDP::CYCLE::FILL)))
+      .add(RDP::setFillColor({0, 0, 0, 0}))
+      .add(RDP::fillRect(0, 0, state.fb->width-1, state.fb->height-1))
+      .runSync();
+
+    constexpr float FRAME_TICKS = TICKS_PER_SECOND / 60.0f;
+
+    int posY = 32;
+    Text::setColor({0xBB, 0xBB, 0xBB});
+    Text::print(16, posY, "Kernel          Ticks/op  ns/op %Frame");
+    Text::setColor();
+    posY += 12;
+
+    auto kernels = Bench::kernels();
+    for(uint32_t k=0; k<results.size(); ++k)
+    {
+      float ticks = results[k].ticksPerOp;
+      Text::printFmt(16, posY, "%-16s%8.1f%7.0f%6.2f",
+        kernels[k].name, ticks, ticks * (1e9f / TICKS_PER_SECOND), ticks * 100.0f / FRAME_TICKS
+      );
+      posY += 8;
+    }
+
+    Text::setSpaceHidden(false);
+    Text::print(16, 220, "A - Run again");
+    Text::setSpaceHidden(true);
+  }
+}
@@ -0,0 +1,219 @@
+/**
+* @copyright 2025 - Max Bebök
+* @license MIT
+*/
+#include "../main.h"
+#include "../text.h"
+#include "../miMemory.h"
+#include "../rdp/rdp.h"
+#include "../rdp/dpl.h"
+
+#include <array>
+
+namespace
+{
+  enum Method : uint32_t {
+    MEMSET = 0,   // libc memset into uncached memory, like the old framebuffer clear
+    ST64_CACHED,  // 64-bit stores through the cache, incl. the writeback to RDRAM
+    ST64_UNCACHED,
+    MI_WRITE,     // MiMem::write, split at 0x800 boundaries
+    MI_ZERO,      // MiMem::zeroUnaligned, split at 0x800 boundaries
+    RDP_FILL,     // fill-mode rectangle, incl. submission and sync
+    METHOD_COUNT
+  };
+
+  constexpr const char* METHOD_NAMES[METHOD_COUNT]{
+    "memset", "st64-cached", "st64-uncached", "mi-write", "mi-zero", "rdp-fill"
+  };
+  constexpr const char* METHOD_SHORT[METHOD_COUNT]{"mset", "stC", "stU", "MIwr", "MI0", "RDP"};
+
+  // from 8 bytes up to a full 320x240 framebuffer
+  constexpr std::array<uint32_t, 8> SIZES{8, 32, 128, 512, 2048, 8192, 32768, 320*240*2};
+  constexpr uint32_t ALIGNMENTS = 8;
+
+  // each measurement repeats a fill until it covers at least this many bytes
+  constexpr uint32_t MIN_BYTES_PER_RUN = 64 * 1024;
+  constexpr uint32_t MI_WRAP_SIZE = 0x800;
+
+  constexpr float TICKS_PER_US = TICKS_PER_SECOND / 1'000'000.0f;
+
+  // bytes/us per method, size and alignment, negative if not possible (RDP on odd addresses)
+  constinit float results[METHOD_COUNT][SIZES.size()][ALIGNMENTS]{};
+  constinit bool needsRun{};
+  constinit uint32_t shownAlign{};
+
+  void storeBytes(uint8_t *dst, uint32_t bytes) {
+    for(uint32_t i=0; i<bytes; ++i)((volatile uint8_t*)dst)[i] = 0;
+  }
+
+  void fillStore64(uint8_t *dst, uint32_t size) {
+    uint32_t head = (8 - ((uintptr_t)dst & 0b111)) & 0b111;
+    if(head > size)head = size;
+    storeBytes(dst, head);
+    dst += head; size -= head;
+
+    auto dst64 = (volatile uint64_t*)dst;
+    for(uint32_t i=0; i<size/8; ++i)dst64[i] = 0;
+    storeBytes(dst + (size & ~0b111), size & 0b111);
+  }
+
+  // a single repeat-write wraps inside a 0x800 block, longer fills are split
+  void fillMI(uint8_t *dst, uint32_t size, bool zeroOnly) {
+    while(size) {
+      uint32_t chunk = MI_WRAP_SIZE - ((uintptr_t)dst & (MI_WRAP_SIZE-1));
+      if(chunk > size)chunk = size;
+      if(chunk < 8) {
+        storeBytes(dst, chunk);
+      } else if(zeroOnly) {
+        MiMem::zeroUnaligned((volatile char*)dst, chunk);
+      } else {
+        MiMem::write(dst, 0, chunk);
+      }
+      dst += chunk;
+      size -= chunk;
+    }
+  }
+
+  // the framebuffer is treated as 1024px wide (full stride), so any linear range is a rectangle
+  void fillRDP(RDP::DPL &dpl, uint8_t *dst, uint32_t size) {
+    uint32_t rowPixels = state.fb->stride / 2;
+    uint32_t offset = (dst - (uint8_t*)state.fb->buffer) / 2;
+    uint32_t pixels = size / 2;
+    uint32_t width = pixels < rowPixels ? pixels : rowPixels;
+
+    dpl.reset();
+    dpl.add(RDP::syncPipe())
+      .add(RDP::setColorImage(state.fb->buffer, RDP::Format::RGBA, RDP::BBP::_16, rowPixels))
+      .add(RDP::setScissor(0, 0, rowPixels-1, state.fb->height-1))
+      .add(RDP::setOtherModes(RDP::OtherMode().cycleType(RDP::CYCLE::FILL)))
+      .add(RDP::setFillColor({0, 0, 0, 0}))
+      .add(RDP::fillRect(offset, 0, offset + width - 1, pixels / width - 1))
+      .runSync();
+  }
+
+  float measure(RDP::DPL &dpl, Method method, uint32_t size, uint32_t align)
+  {
+    if(method == RDP_FILL && (align & 1))return -1.0f;
+
+    auto dst = (uint8_t*)state.fb->buffer + align;
+    auto dstCached = (uint8_t*)CachedAddr(dst);
+    uint32_t reps = (MIN_BYTES_PER_RUN + size - 1) / size;
+
+    disable_interrupts();
+    uint64_t ticks = get_ticks();
+    for(uint32_t r=0; r<reps; ++r)
+    {
+      switch(method) {
+        case MEMSET       : memset(dst, 0, size); break;
+        case ST64_CACHED  :
+          fillStore64(dstCached, size);
+          data_cache_hit_writeback_invalidate(dstCached, size);
+        break;
+        case ST64_UNCACHED: fillStore64(dst, size); break;
+        case MI_WRITE     : fillMI(dst, size, false); break;
+        case MI_ZERO      : fillMI(dst, size, true); break;
+        case RDP_FILL     : fillRDP(dpl, dst, size); break;
+        default: break;
+      }
+    }
+    ticks = get_ticks() - ticks;
+    enable_interrupts();
+
+    return (float)size * reps / (ticks / TICKS_PER_US);
+  }
+
+  void runAll()
+  {
+    RDP::DPL dpl{8};
+    for(uint32_t m=0; m<METHOD_COUNT; ++m) {
+      for(uint32_t s=0; s<SIZES.size(); ++s) {
+        for(uint32_t a=0; a<ALIGNMENTS; ++a) {
+          results[m][s][a] = measure(dpl, (Method)m, SIZES[s], a);
+        }
+      }
+    }
+
+    debugf("method,size,align,bytes_per_us\n");
+    for(uint32_t m=0; m<METHOD_COUNT; ++m) {
+      for(uint32_t s=0; s<SIZES.size(); ++s) {
+        for(uint32_t a=0; a<ALIGNMENTS; ++a) {
+          if(results[m][s][a] < 0)continue;
+          debugf("%s,%lu,%lu,%.2f\n", METHOD_NAMES[m], SIZES[s], a, results[m][s][a]);
+        }
+      }
+    }
+  }
+}
+
+namespace Demo::FillBench
+{
+  extern const char* const name = "Memory Fill Bench";
+
+  void init() {
+    needsRun = true;
+    shownAlign = 0;
+  }
+
+  void destroy() {
+  }
+
+  void draw()
+  {
+    auto pressed = joypad_get_buttons_pressed(JOYPAD_PORT_1);
+    if(pressed.a)needsRun = true;
+    if(pressed.c_right || pressed.d_right)shownAlign = (shownAlign + 1) % ALIGNMENTS;
+    if(pressed.c_left || pressed.d_left)shownAlign = (shownAlign + ALIGNMENTS - 1) % ALIGNMENTS;
+
+    // fills target the current framebuffer, so they run before the clear
+    if(needsRun) {
+      runAll();
+      needsRun = false;
+    }
+
+    RDP::DPL dpl{8};
+    dpl.add(RDP::syncPipe())
+      .add(RDP::setColorImage(state.fb->buffer, RDP::Format::RGBA, RDP::BBP::_16, state.fb->stride/2))
+      .add(RDP::setScissor(0, 0, state.fb->width-1, state.fb->height-1))
+      .add(RDP::setOtherModes(RDP::OtherMode().cycleType(RDP::CYCLE::FILL)))
+      .add(RDP::setFillColor({0, 0, 0, 0}))
+      .add(RDP::fillRect(0, 0, state.fb->width-1, state.fb->height-1))
+      .runSync();
+
+    int posY = 32;
+    Text::setColor({0xBB, 0xBB, 0xBB});
+    Text::printFmt(16, posY, "Bytes/us, alignment: %u", shownAlign);
+    posY += 12;
+
+    Text::print(16, posY, "Size");
+    for(uint32_t m=0; m<METHOD_COUNT; ++m) {
+      Text::printFmt(16 + 40 + m * 40, posY, "%4s", METHOD_SHORT[m]);
+    }
+    Text::setColor();
+    posY += 10;
+
+    for(uint32_t s=0; s<SIZES.size(); ++s)
+    {
+      uint32_t size = SIZES[s];
+      if(size >= 1024) {
+        Text::printFmt(16, posY, "%uK", size / 1024);
+      } else {
+        Text::printFmt(16, posY, "%u", size);
+      }
+
+      for(uint32_t m=0; m<METHOD_COUNT; ++m) {
+        float value = results[m][s][shownAlign];
+        int posX = 16 + 40 + m * 40;
+        if(value < 0) {
+          Text::print(posX, posY, "   -");
+        } else {
+          Text::printFmt(posX, posY, "%4.0f", value);
+        }
+      }
+      posY += 9;
+    }
+
+    Text::setSpaceHidden(false);
+    Text::print(16, 212, "A - Run again   C/D L/R - Align");
+    Text::setSpaceHidden(true);
+  }
+}
@@ -6,35 +6,18 @@
 #include "../rdp/rdp.h"
 #include "../rdp/dpl.h"
 #include "../rdpDumpTest.h"
+#include "../testRegion.h"
+#include "../testGen.h"
 
 #include <array>
 #include <cmath>
 
 namespace
 {
-  constinit uint32_t seed = 0x12345678;
-  uint32_t fixedRand()
-  {
-    seed ^= (seed << 13);
-    seed ^= (seed >> 17);
-    seed ^= (seed << 5);
-    return seed;
-  }
-
-  float fixedRandfs() {
-    return ((fixedRand() & 0xFFFF) / 32768.0f) - 1.0f;
-  }
-
-  constinit RDPDumpTest dumpTest{
-    .testCases = std::array<uint32_t, 20>({
-      0x73bfd1a2u, 0x3809113eu, 0x17d6a1e3u, 0x392df0aau, 0x0f4529b0u,
-      0x38bb9993u, 0x8216fc78u, 0x06868e65u, 0x255206b1u, 0x59b323c8u,
-      0x6f2489a4u, 0xa2aaae1du, 0xb6a33922u, 0x0a5212bbu, 0xf2dcebddu,
-      0xe58b24beu, 0x7be66493u, 0x9f605ee7u, 0x336a3a0au, 0xa3a56459u,
-    }),
-    .testRegion = std::array<int, 4>({
-      16, 48, SCREEN_WIDTH-16, SCREEN_HEIGHT-48
-    })
+  RDPDumpTest dumpTest{
+    .allowSweep = true,
+    .testCases = {TestGen::FILL_TRI_SEEDS.begin(), TestGen::FILL_TRI_SEEDS.end()},
+    .testRegion = TestRegion::RECT
   };
 }
 
@@ -48,11 +31,15 @@ namespace Demo::RDPFillTri
 
   void destroy() {}
 
+  RDPDumpTest* tests() {
+    return &dumpTest;
+  }
+
   void draw()
   {
     dumpTest.run([](uint32_t testCase)
     {
-      seed = testCase;
+      auto tri = TestGen::fillTri(testCase);
 
       RDP::DPL dpl{128};
       dpl.add(RDP::syncPipe())
@@ -65,16 +52,6 @@ namespace Demo::RDPFillTri
         .add(RDP::fillRect(0, 0, 320-1, 240-1))
         .runSync();
 
-      float triPos[3][2]{
-        {fixedRandfs() * 150.0f, fixedRandfs() * 150.0f},
-        {fixedRandfs() * 150.0f, fixedRandfs() * 150.0f},
-        {fixedRandfs() * 150.0f, fixedRandfs() * 150.0f}
-      };
-      for(auto &p : triPos) {
-        p[0] += SCREEN_WIDTH / 2.0f;
-        p[1] += SCREEN_HEIGHT / 2.0f;
-      }
-
       RDP::DPL dplTri{64};
       dplTri.add(RDP::syncPipe())
         .add(RDP::setFillColor({0x22, 0x22, 0x22, 0}))
@@ -82,11 +59,11 @@ namespace Demo::RDPFillTri
         .add(RDP::fillRect(dumpTest.testRegion[0], dumpTest.testRegion[1], dumpTest.testRegion[2], dumpTest.testRegion[3]))
         .add(RDP::syncPipe())
 
-        .add(RDP::setFillColorRaw(fixedRand()))
+        .add(RDP::setFillColorRaw(tri.fillColor))
         .add(RDP::triangle(0,
-          {.pos = {triPos[0][0], triPos[0][1]}},
-          {.pos = {triPos[1][0], triPos[1][1]}},
-          {.pos = {triPos[2][0], triPos[2][1]}}
+          {.pos = {tri.pos[0][0], tri.pos[0][1]}},
+          {.pos = {tri.pos[1][0], tri.pos[1][1]}},
+          {.pos = {tri.pos[2][0], tri.pos[2][1]}}
          ))
         .runSync(TICKS_FROM_MS(100));
     });
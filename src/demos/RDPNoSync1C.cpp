@@ -6,16 +6,17 @@
 #include "../rdp/rdp.h"
 #include "../rdp/dpl.h"
 #include "../rdpDumpTest.h"
+#include "../testRegion.h"
 
 #include <array>
 #include <cmath>
 
 namespace
 {
-  constinit RDPDumpTest dumpTest{
-    .testRegion = std::array<int, 4>({
-      16, 48, SCREEN_WIDTH-16, SCREEN_HEIGHT-48
-    })
+  constexpr uint32_t TEST_CASE_COUNT = 20;
+
+  RDPDumpTest dumpTest{
+    .testRegion = TestRegion::RECT
   };
 
   float lastY = 0;
@@ -26,7 +27,8 @@ namespace Demo::RDPNoSync1C
   extern const char* const name = "RDP 1-Cycle No-Sync";
 
   void init() {
-    for(uint32_t t=0; t<dumpTest.testCases.size(); ++t) {
+    dumpTest.testCases.resize(TEST_CASE_COUNT);
+    for(uint32_t t=0; t<TEST_CASE_COUNT; ++t) {
       dumpTest.testCases[t] = 0x1000'0000 | t;
     }
     dumpTest.reset();
@@ -34,6 +36,10 @@ namespace Demo::RDPNoSync1C
 
   void destroy() {}
 
+  RDPDumpTest* tests() {
+    return &dumpTest;
+  }
+
   void draw()
   {
     lastY = 0;
@@ -206,7 +206,7 @@ namespace Demo::RDPTestMode
           if(!isDone)
           {
             Text::setColor(colors[j]);
-            Text::printf(textPosX, posY, cvg < 4 ? CVG_CHAR[cvg] : "?");
+            Text::print(textPosX, posY, cvg < 4 ? CVG_CHAR[cvg] : "?");
             Text::setColor();
             textPosX += 8;
             ++pixelCount;
@@ -267,14 +267,14 @@ namespace Demo::RDPTestMode
       bool pass = RDPBuff::read(i) == TEST_VALUES[i].read;
       okCount += pass ? 1 : 0;
       if(!pass) {
-        Text::printf(148, textY,  "%01X:%08X!=%08X", i, RDPBuff::read(i), TEST_VALUES[i].read);
+        Text::printFmt(148, textY, "%01X:%08X!=%08X", i, RDPBuff::read(i), TEST_VALUES[i].read);
         textY += 8;
       }
     }
 
     Text::setColor();
 
-    Text::printf(80, 16, "Span-R/W: %d/%d (%s)",
+    Text::printFmt(80, 16, "Span-R/W: %d/%d (%s)",
       okCount, (int)TEST_VALUES.size(),
       okCount == (int)TEST_VALUES.size() ? "OK" : "FAIL!"
     );
@@ -6,35 +6,18 @@
 #include "../rdp/rdp.h"
 #include "../rdp/dpl.h"
 #include "../rdpDumpTest.h"
+#include "../testRegion.h"
+#include "../testGen.h"
 
 #include <array>
 #include <cmath>
 
 namespace
 {
-  constinit uint32_t seed = 0x12345678;
-  uint32_t fixedRand()
-  {
-    seed ^= (seed << 13);
-    seed ^= (seed >> 17);
-    seed ^= (seed << 5);
-    return seed;
-  }
-
-  float fixedRandf() {
-    return ((fixedRand() & 0xFFFF) / (float)0xFFFF);
-  }
-
-  constinit RDPDumpTest dumpTest{
-    .testCases = std::array<uint32_t, 20>({
-      0x949db639u, 0x79e6622eu, 0xbff1a7abu, 0xb97daba5u, 0xf029c740u,
-      0xc221ef19u, 0x3e5e8f05u, 0x40cb07a2u, 0x32c9921au, 0x84f09d97u,
-      0x77107f77u, 0x63a04322u, 0x2804ac62u, 0x3419e23au, 0x33fd636fu,
-      0x563c6060u, 0x856d5300u, 0xdf19d3cfu, 0x1fc4b690u, 0x5c2f3fceu,
-    }),
-    .testRegion = std::array<int, 4>({
-      16, 48, SCREEN_WIDTH-16, SCREEN_HEIGHT-48
-    })
+  RDPDumpTest dumpTest{
+    .allowSweep = true,
+    .testCases = {TestGen::UNDEF_SHADE_SEEDS.begin(), TestGen::UNDEF_SHADE_SEEDS.end()},
+    .testRegion = TestRegion::RECT
   };
 }
 
@@ -48,11 +31,15 @@ namespace Demo::RDPUndefShade
 
   void destroy() {}
 
+  RDPDumpTest* tests() {
+    return &dumpTest;
+  }
+
   void draw()
   {
     dumpTest.run([](uint32_t testCase)
     {
-      seed = testCase;
+      auto tri = TestGen::undefShadeTri(testCase);
 
       RDP::DPL dpl{128};
       dpl.add(RDP::syncPipe())
@@ -65,12 +52,6 @@ namespace Demo::RDPUndefShade
         .add(RDP::fillRect(0, 0, 320-1, 240-1))
         .runSync();
 
-      float triPos[3][2]{
-        {fixedRandf() * 250.0f - 100.0f, fixedRandf() * 360.0f},
-        {fixedRandf() * 450.0f, fixedRandf() * 260.0f},
-        {fixedRandf() * 450.0f, fixedRandf() * 360.0f}
-      };
-
       RDP::DPL dplTri{128};
       dplTri.add(RDP::syncPipe())
         .add(RDP::setFillColor({0x11, 0x11, 0x22, 0}))
@@ -91,9 +72,9 @@ namespace Demo::RDPUndefShade
           (0,0,0,SHADE), (0,0,0,1)))
         )
         .add(RDP::triangle(0,
-          {.pos = {triPos[0][0], triPos[0][1]}},
-          {.pos = {triPos[1][0], triPos[1][1]}},
-          {.pos = {triPos[2][0], triPos[2][1]}}
+          {.pos = {tri.pos[0][0], tri.pos[0][1]}},
+          {.pos = {tri.pos[1][0], tri.pos[1][1]}},
+          {.pos = {tri.pos[2][0], tri.pos[2][1]}}
          ))
         .runSync(TICKS_FROM_MS(100));
     });
@@ -50,6 +50,12 @@ namespace
   };
 
   constinit bool isEmu{false};
+
+  constexpr int LINE_COUNT = 240;
+  // per-line sine terms of the wave, evaluated once per frame
+  constinit float sinA[LINE_COUNT]{};
+  constinit float sinB[LINE_COUNT]{};
+  constinit float sinC[LINE_COUNT]{};
 }
 
 namespace Demo::Repeat
@@ -68,17 +74,20 @@ namespace Demo::Repeat
     disable_interrupts();
 
     uint32_t baseLineSize = 40;
-    float sinBase = 0;
     uint32_t idxStart = 0;
 
     uint64_t col=0;
 
-    for(int i=0; i<240; ++i) {
+    constexpr float SIN_STEP = 0.03f;
+    Math::sinBatch(sinA, SIN_STEP + state.time,              SIN_STEP,         LINE_COUNT);
+    Math::sinBatch(sinB, SIN_STEP * 5.0f + state.time*1.5f,  SIN_STEP * 5.0f,  LINE_COUNT);
+    Math::sinBatch(sinC, SIN_STEP * 15.0f + state.time*1.7f, SIN_STEP * 15.0f, LINE_COUNT);
+
+    for(int i=0; i<LINE_COUNT; ++i) {
       //if(i % 2 == 0)continue;
-      sinBase += 0.03f;
-      float offset  = Math::sinApprox(sinBase + state.time) * 0.5f;
-      float offsetB = Math::sinApprox(sinBase * 5.0f + state.time*1.5f);
-      float offsetC = Math::sinApprox(sinBase * 15.0f + state.time*1.7f);
+      float offset  = sinA[i] * 0.5f;
+      float offsetB = sinB[i];
+      float offsetC = sinC[i];
       offset += offsetB * 0.2f + offsetC * 0.1f;
 
       uint32_t idxOffset = 200 + ((int)(offset*128) & ~0b1);
@@ -8,10 +8,8 @@
 #include "../rdp/rdp.h"
 #include "../rdp/dpl.h"
 #include "../text.h"
-
-extern "C" {
-  void vi_debug_dump(int verbose);
-}
+#include "../viTimeline.h"
+#include "../taskQueue.h"
 
 namespace {
   color_t getRainbowColor(uint32_t t) {
@@ -35,6 +33,79 @@ namespace {
         case 5: return {0xFF, 0x00,  q  };
     }
   }
+
+  // VI_V_CURRENT counts half-lines, up to 525 for NTSC
+  constexpr uint32_t LINE_COUNT = 526;
+  // per-line sine terms, evaluated once per frame so the line loop only does lookups
+  constinit float sinA[LINE_COUNT]{};
+  constinit float sinB[LINE_COUNT]{};
+
+  constexpr int HIST_HEIGHT = 40;
+  constexpr int HIST_BOTTOM = 180;
+
+  // registers as set up by libdragon, restored after the last line
+  constinit uint32_t orgXScale{};
+  constinit uint32_t orgHVideo{};
+
+  constexpr uint32_t START_LINE = 20;
+  constexpr uint32_t END_LINE = 486;
+  constexpr uint32_t LINES_PER_CHECK = 16; // lines between deadline checks
+
+  // table of the next frame, built as a task while main waits for a framebuffer
+  struct TableBuild {
+    float time;
+    uint32_t line; // next line to add, 0 before the first slice
+    int scaleA, scaleB;
+    uint64_t ticks; // total time of all slices
+    bool pending;
+  };
+  constinit TableBuild build{};
+  constinit uint32_t lastBuildUs{};
+
+  bool buildTable(uint64_t deadline)
+  {
+    uint64_t ticksStart = get_ticks();
+    if(build.line == 0) {
+      Math::sinBatch(sinA, build.time,        1.0f / 60.0f, LINE_COUNT);
+      Math::sinBatch(sinB, -build.time*1.3f,  1.0f / 50.0f, LINE_COUNT);
+
+      // lines up to 'START_LINE' are blanked
+      VITimeline::begin();
+      VITimeline::add(VI_V_CURRENT_VBLANK + 2, VI_X_SCALE, 0x10);
+      VITimeline::add(VI_V_CURRENT_VBLANK + 2, VI_H_VIDEO, 0);
+      build.line = START_LINE+2;
+    }
+
+    for(; build.line<=END_LINE; build.line+=2)
+    {
+      int pixelStart = 110 + build.scaleA;
+      int pixelEnd = 740;
+
+      build.scaleB *= 2;
+      build.scaleB += build.scaleA;
+
+      VITimeline::add(build.line, VI_X_SCALE, 0x200 + build.scaleB + 40);
+      VITimeline::add(build.line, VI_H_VIDEO, pixelEnd | (pixelStart << 16));
+
+      build.scaleA = sinA[build.line+1] * 50 + 50;
+      build.scaleB = sinB[build.line+1] * 30 + 30;
+
+      if((build.line % (LINES_PER_CHECK*2)) == 0 && get_ticks() >= deadline) {
+        build.line += 2;
+        build.ticks += get_ticks() - ticksStart;
+        return false;
+      }
+    }
+
+    VITimeline::add(END_LINE+2, VI_X_SCALE, orgXScale);
+    VITimeline::add(END_LINE+2, VI_H_VIDEO, orgHVideo);
+    VITimeline::submit();
+
+    build.ticks += get_ticks() - ticksStart;
+    lastBuildUs = TICKS_TO_US(build.ticks);
+    build.pending = false;
+    return true;
+  }
 }
 
 namespace Demo::VI
@@ -43,11 +114,13 @@ namespace Demo::VI
 
   void init()
   {
-
+    orgXScale = *VI_X_SCALE;
+    orgHVideo = *VI_H_VIDEO;
   }
 
   void destroy() {
-
+    VITimeline::setRecording(false);
+    build.pending = false;
   }
 
   void draw()
@@ -75,57 +148,50 @@ namespace Demo::VI
           .add(RDP::fillRect(x, y, x+16, y+16));
       }
     }
-    dpl.runAsync();
-
-    uint32_t orgXScale = *VI_X_SCALE;
-    uint32_t orgHVideo = *VI_H_VIDEO;
-
-    uint32_t lastLine = *VI_V_CURRENT;
-
-    if(state.frame < 3)return;
-
-    //vi_debug_dump(1);
-
-    constexpr int startLine = 20;
-    int scaleA = 0;
-    int scaleB = 0;
-
-    while(lastLine < 486) {
-      uint32_t scanLine = *VI_V_CURRENT;
-      if(scanLine != lastLine) {
-        if(lastLine > startLine) {
 
-          int pixelStart = 110 + scaleA;
-          int pixelEnd = 740;
-
-          scaleB *= 2;
-          scaleB += scaleA;
-
-          MEMORY_BARRIER();
-          *VI_X_SCALE = (0x200 + scaleB + 40);
-          *VI_H_VIDEO = pixelEnd | (pixelStart << 16);
-          MEMORY_BARRIER();
-
-          scaleA = Math::sinApprox(((scanLine+1) / 60.0f) + state.time) * 50 + 50;
-          scaleB = Math::sinApprox(((scanLine+1) / 50.0f) - state.time*1.3f) * 30 + 30;
-
-        } else {
-          MEMORY_BARRIER();
-          *VI_X_SCALE = 0x10;
-          *VI_H_VIDEO = 0;
-          MEMORY_BARRIER();
-        }
-        lastLine = scanLine;
+    // timing of the line-interrupts of the previous frame
+    auto stats = VITimeline::getStats();
+    char statsText[Text::Fmt::BUFF_SIZE];
+    Text::format(statsText, sizeof(statsText), "IRQs:%u`late:%u`jitter:%ut`table:%uus",
+      stats.interrupts, stats.lateWrites, stats.lineTicksMax - stats.lineTicksMin, lastBuildUs
+    );
+
+    // A: record write latencies (histogram bars, one per 64 ticks), B: dump them to the log
+    auto pressed = joypad_get_buttons_pressed(JOYPAD_PORT_1);
+    if(pressed.a)VITimeline::setRecording(!VITimeline::isRecording());
+    if(pressed.b)VITimeline::logRecording(name);
+
+    char histText[Text::Fmt::BUFF_SIZE]{};
+    if(VITimeline::isRecording()) {
+      auto hist = VITimeline::getHistogram();
+      uint32_t maxCount = 1;
+      for(auto count : hist.buckets)maxCount = count > maxCount ? count : maxCount;
+
+      dpl.add(RDP::syncPipe())
+        .add(RDP::setFillColor({0xFF, 0xFF, 0xFF, 0xFF}));
+      for(uint32_t i=0; i<VITimeline::HIST_BUCKETS; ++i) {
+        int height = hist.buckets[i] * HIST_HEIGHT / maxCount;
+        if(height > 0)dpl.add(RDP::fillRect(32 + i*8, HIST_BOTTOM - height, 32 + i*8 + 5, HIST_BOTTOM));
       }
+
+      Text::format(histText, sizeof(histText), "max:%ut`missed:%u`n:%u",
+        hist.maxTicks, hist.missedLines, hist.samples
+      );
     }
 
-    MEMORY_BARRIER();
-    *VI_X_SCALE = orgXScale;
-    *VI_H_VIDEO = orgHVideo;
-    MEMORY_BARRIER();
+    // text is drawn by the RDP too, the VI writes below run from interrupts
+    Text::Batch::begin(dpl);
+    Text::Batch::print(dpl, 52, 100, "This`screen`should`~wobble~");
+    Text::Batch::print(dpl, 32, HIST_BOTTOM + 4, histText);
+    Text::Batch::print(dpl, 32, 240-32, statsText);
+    Text::Batch::print(dpl, 32, 240-16, "Per-Line VI_X_SCALE / VI_H_VIDEO");
+    dpl.runAsync();
 
-    Text::print(52, 100, "This`screen`should`~wobble~");
+    if(state.frame < 3 || build.pending)return;
 
-    Text::print(32, 240-16, "Per-Line VI_X_SCALE / VI_H_VIDEO");
+    // the table is only needed at the next vblank, so it is built in the wait for the next framebuffer.
+    // If that is not done in time, this frame keeps the previous table.
+    build = {.time = state.time, .line = 0, .scaleA = 0, .scaleB = 0, .ticks = 0, .pending = true};
+    if(!TaskQueue::push(buildTable))build.pending = false;
   }
-}
\ No newline at end of file
+}
@@ -7,6 +7,7 @@
 #include "../rdp/rdp.h"
 #include "../rdp/dpl.h"
 #include "../text.h"
+#include "../viTimeline.h"
 
 namespace {
   constexpr uint32_t posToScanline(float height) {
@@ -24,6 +25,9 @@ namespace {
   constexpr uint32_t linePaddle0End = posToScanline(PADDLE_POS_Y[0] + PADDLE_HEIGHT);
   constexpr uint32_t lineBallEnd = posToScanline(PADDLE_POS_Y[1]);
 
+  constexpr uint32_t START_LINE = 20;
+  constexpr uint32_t END_LINE = 480;
+
   constinit int paddlePosX[2]{32, 32};
   constinit float ballPos[2]{};
 
@@ -31,6 +35,18 @@ namespace {
   constinit float ballVelStart[2]{0.0f, 0.0f};
 
   constinit int points[2]{0,0};
+  constinit Text::Layer::Handle textPoints = 0;
+  constinit Text::Layer::Handle textLatency = 0;
+  constinit Text::Layer::Handle textInputLag = 0;
+
+  // input-to-display: from the joypad poll that starts a paddle movement to the first VI write showing it
+  constinit uint64_t lagInputTicks{};
+  constinit bool lagPending{};
+  constinit bool lagBeamRacing{};
+  constinit uint32_t lagUs{};
+
+  // register as set up by libdragon, restored after the last line
+  constinit uint32_t orgHVideo = 0;
 
   constinit uint32_t scanlineBall = 0;
   constinit uint32_t scanlineBallEnd = 0;
@@ -64,12 +80,73 @@ namespace {
     ballVel[1-axis] += (float)(rand() % 16) / 64.0f;
   }
 
+  uint32_t hVideoForLine(uint32_t line)
+  {
+    int pixelStart = 108;
+    int pixelEnd = 748;
+
+    // paddle 0
+    if(line >= linePaddle0Start && line <= linePaddle0End) {
+      pixelStart += paddlePosX[0] * 2;
+    }
+
+    // paddle 1
+    if(line > lineBallEnd) {
+      pixelStart += paddlePosX[1] * 2;
+    } else if(line > linePaddle0End) {
+      // ball
+      if(line >= scanlineBall && line <= scanlineBallEnd) {
+        pixelStart += (int)ballPos[0]*2;
+      } else {
+        pixelStart = 0;
+        pixelEnd = 0;
+      }
+    }
+    return pixelEnd | (pixelStart << 16);
+  }
+
+  // rows [y0, y1) of the static image, the VI registers move everything around
+  void drawScene(uint32_t y0, uint32_t y1)
+  {
+    RDP::DPL dpl{64};
+    dpl.add(RDP::syncPipe())
+      .add(RDP::setColorImage(state.fb->buffer, RDP::Format::RGBA, RDP::BBP::_16, state.fb->stride/2))
+      .add(RDP::setScissor(0, y0, state.fb->width-1, y1))
+      .add(RDP::setOtherModes(RDP::OtherMode()
+        .cycleType(RDP::CYCLE::FILL)
+      ))
+      // 2 paddles
+      .add(RDP::syncPipe())
+      .add(RDP::setFillColor({0xAA, 0xFF, 0xAA, 0xFF}))
+      .add(RDP::fillRect(0,PADDLE_POS_Y[0], PADDLE_WIDTH, PADDLE_POS_Y[0] + PADDLE_HEIGHT))
+      .add(RDP::syncPipe())
+      .add(RDP::setFillColor({0x11, 0x11, 0x11, 0xFF}))
+      .add(RDP::fillRect(5, PADDLE_POS_Y[0]+2, PADDLE_WIDTH-2, PADDLE_POS_Y[0] + PADDLE_HEIGHT-2))
+
+      .add(RDP::syncPipe())
+      .add(RDP::setFillColor({0xFF, 0xAA, 0xAA, 0xFF}))
+      .add(RDP::fillRect(0,PADDLE_POS_Y[1], PADDLE_WIDTH, PADDLE_POS_Y[1] + PADDLE_HEIGHT))
+      .add(RDP::syncPipe())
+      .add(RDP::setFillColor({0x11, 0x11, 0x11, 0xFF}))
+      .add(RDP::fillRect(5, PADDLE_POS_Y[1]+2, PADDLE_WIDTH-2, PADDLE_POS_Y[1] + PADDLE_HEIGHT-2))
+
+      // ball, stretches entire height
+      .add(RDP::syncPipe())
+      .add(RDP::setFillColor({0x66, 0x66, 0xFF, 0xFF}))
+      .add(RDP::fillRect(0, BALL_START_Y + 2, 16, PADDLE_POS_Y[1] - 2))
+      .runAsync();
+  }
+
   void updateGame()
   {
     constexpr int MAX_PADDLE_X = 240;
 
     // input
     auto held = joypad_get_buttons_held(JOYPAD_PORT_1);
+    auto pressed = joypad_get_buttons_pressed(JOYPAD_PORT_1);
+    uint32_t oldHVideo = hVideoForLine(linePaddle0Start);
+    int oldPaddleX = paddlePosX[0];
+
     if(held.c_left || held.d_left)paddlePosX[0] -= 2;
     if(held.c_right || held.d_right)paddlePosX[0] += 2;
 
@@ -90,6 +167,15 @@ namespace {
       if(paddlePosX[i] > MAX_PADDLE_X)paddlePosX[i] = MAX_PADDLE_X;
     }
 
+    // a movement starting from rest, the paddle line keeps the old value until the change is displayed
+    bool startsMoving = pressed.c_left || pressed.d_left || pressed.c_right || pressed.d_right;
+    if(startsMoving && !lagPending && paddlePosX[0] != oldPaddleX) {
+      VITimeline::armProbe(linePaddle0Start, VI_H_VIDEO, oldHVideo);
+      lagInputTicks = state.inputTicks;
+      lagBeamRacing = state.beamRacing;
+      lagPending = true;
+    }
+
     // ball
     for(int i=0; i<2; ++i) {
       ballVelStart[i] += 0.05f;
@@ -147,95 +233,90 @@ namespace Demo::VIPong
     ballPos[1] = 0;
     points[0] = 0;
     points[1] = 0;
+    lagPending = false;
+    lagUs = 0;
     respawn();
+    orgHVideo = *VI_H_VIDEO;
+
+    // only the paddles get redrawn, text can stay in the buffers
+    state.clearsScreen = false;
+    Text::Layer::print(Text::Layer::create(), 16, 240-16, "[VI-Pong]");
+    textPoints = Text::Layer::create();
+    textLatency = Text::Layer::create();
+    textInputLag = Text::Layer::create();
   }
 
   void destroy() {
-
+    VITimeline::setRecording(false);
   }
 
   void draw()
   {
-    RDP::DPL dpl{64};
-    dpl.add(RDP::syncPipe())
-      .add(RDP::setColorImage(state.fb->buffer, RDP::Format::RGBA, RDP::BBP::_16, state.fb->stride/2))
-      .add(RDP::setScissor(0, 0, state.fb->width-1, state.fb->height-1))
-      .add(RDP::setOtherModes(RDP::OtherMode()
-        .cycleType(RDP::CYCLE::FILL)
-      ))
-      // 2 paddles
-      .add(RDP::syncPipe())
-      .add(RDP::setFillColor({0xAA, 0xFF, 0xAA, 0xFF}))
-      .add(RDP::fillRect(0,PADDLE_POS_Y[0], PADDLE_WIDTH, PADDLE_POS_Y[0] + PADDLE_HEIGHT))
-      .add(RDP::syncPipe())
-      .add(RDP::setFillColor({0x11, 0x11, 0x11, 0xFF}))
-      .add(RDP::fillRect(5, PADDLE_POS_Y[0]+2, PADDLE_WIDTH-2, PADDLE_POS_Y[0] + PADDLE_HEIGHT-2))
-
-      .add(RDP::syncPipe())
-      .add(RDP::setFillColor({0xFF, 0xAA, 0xAA, 0xFF}))
-      .add(RDP::fillRect(0,PADDLE_POS_Y[1], PADDLE_WIDTH, PADDLE_POS_Y[1] + PADDLE_HEIGHT))
-      .add(RDP::syncPipe())
-      .add(RDP::setFillColor({0x11, 0x11, 0x11, 0xFF}))
-      .add(RDP::fillRect(5, PADDLE_POS_Y[1]+2, PADDLE_WIDTH-2, PADDLE_POS_Y[1] + PADDLE_HEIGHT-2))
-
-      // ball, stretches entire height
-      .add(RDP::syncPipe())
-      .add(RDP::setFillColor({0x66, 0x66, 0xFF, 0xFF}))
-      .add(RDP::fillRect(0, BALL_START_Y + 2, 16, PADDLE_POS_Y[1] - 2))
-      .runAsync();
+    bool beamRacing = state.beamRacing;
 
+    // runs right after main polled the input, a task would run during the wait before it and lag a frame
     updateGame();
-
-    uint32_t orgHVideo = *VI_H_VIDEO;
-    uint32_t lastLine = *VI_V_CURRENT;
+    if(!beamRacing) {
+      // beam-racing draws the scene in bands instead
+      drawScene(0, state.fb->height);
+    }
 
     if(state.frame < 3)return;
 
-    //vi_debug_dump(1);
-
-    constexpr int startLine = 20;
-
-    while(lastLine < 480) {
-      uint32_t scanLine = *VI_V_CURRENT;
-      if(scanLine != lastLine) {
-        if(lastLine > startLine) {
-
-          int pixelStart = 108;
-          int pixelEnd = 748;
-
-          // paddle 0
-          if(scanLine >= linePaddle0Start && scanLine <= linePaddle0End) {
-            pixelStart += paddlePosX[0] * 2;
-          }
-
-          // paddle 1
-          if(scanLine > lineBallEnd) {
-            pixelStart += paddlePosX[1] * 2;
-          } else if(scanLine > linePaddle0End) {
-            // ball
-            if(scanLine >= scanlineBall && scanLine <= scanlineBallEnd) {
-              pixelStart += (int)ballPos[0]*2;
-            } else {
-              pixelStart = 0;
-              pixelEnd = 0;
-            }
-          }
-
-          MEMORY_BARRIER();
-          *VI_H_VIDEO = pixelEnd | (pixelStart << 16);
-          MEMORY_BARRIER();
-
-        }
-        lastLine = scanLine;
+    // A: record VI write latencies, B: dump them to the log, Z: toggle beam-racing
+    auto pressed = joypad_get_buttons_pressed(JOYPAD_PORT_1);
+    if(pressed.a)VITimeline::setRecording(!VITimeline::isRecording());
+    if(pressed.b)VITimeline::logRecording(name);
+    if(pressed.z) {
+      state.beamRacing = !beamRacing;
+      lagPending = false;
+    }
+
+    // both switch at the next vblank, so the next frame has its writes either way
+    if(state.beamRacing) {
+      if(!beamRacing)VITimeline::beginLive();
+    } else {
+      // table for the next frame, applied from VI line-interrupts
+      VITimeline::begin();
+      for(uint32_t line=START_LINE+2; line<=END_LINE; line+=2) {
+        VITimeline::add(line, VI_H_VIDEO, hVideoForLine(line));
       }
+      VITimeline::add(END_LINE+2, VI_H_VIDEO, orgHVideo);
+      VITimeline::submit();
     }
 
-    MEMORY_BARRIER();
-    *VI_H_VIDEO = orgHVideo;
-    MEMORY_BARRIER();
+    Text::Layer::printFmt(textPoints, 140, 240-16, "Points: %d ~ %d", points[0], points[1]);
+
+    if(lagPending && VITimeline::getProbeTicks()) {
+      lagUs = TICKS_TO_US(VITimeline::getProbeTicks() - lagInputTicks);
+      lagPending = false;
+      debugf("{\"viPongLagUs\":%lu,\"beamRacing\":%s}\n", lagUs, lagBeamRacing ? "true" : "false");
+    }
+    Text::Layer::printFmt(textInputLag, 140, 4, "%s lag:%.2fms",
+      state.beamRacing ? "beam" : "3-buf", lagUs * (1.0f / 1000.0f)
+    );
+
+    if(VITimeline::isRecording()) {
+      auto hist = VITimeline::getHistogram();
+      Text::Layer::printFmt(textLatency, 140, 16, "VI max:%ut miss:%u", hist.maxTicks, hist.missedLines);
+    } else {
+      Text::Layer::print(textLatency, 140, 16, "");
+    }
+  }
 
-    Text::print(16, 240-16, "[VI-Pong]");
+  // beam-racing: image rows and the VI writes of their lines, submitted while the VI is one band above
+  void drawBand(uint32_t y0, uint32_t y1)
+  {
+    drawScene(y0, y1);
+    if(state.frame < 3)return;
 
-    Text::printf(140, 240-16, "Points: %d ~ %d", points[0], points[1]);
+    uint32_t lineStart = y0 == 0 ? START_LINE+2 : posToScanline(y0);
+    uint32_t lineEnd = posToScanline(y1);
+    for(uint32_t line=lineStart; line<lineEnd && line<=END_LINE; line+=2) {
+      VITimeline::addLive(line, VI_H_VIDEO, hVideoForLine(line));
+    }
+    if(lineStart <= END_LINE+2 && END_LINE+2 < lineEnd) {
+      VITimeline::addLive(END_LINE+2, VI_H_VIDEO, orgHVideo);
+    }
   }
-}
\ No newline at end of file
+}
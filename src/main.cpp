@@ -6,9 +6,17 @@
 #include <vector>
 #include "text.h"
 #include "main.h"
+#include "rdpDumpTest.h"
+#include "refPack.h"
+#include "miMemory.h"
+#include "viTimeline.h"
+#include "taskQueue.h"
 
+// 'tests' and 'drawBand' are optional, only demos with a dump-test suite define it
 #define DEMO_ENTRY(X) namespace Demo::X { \
   void init(); void draw(); void destroy(); extern const char* const name; \
+  RDPDumpTest* tests() __attribute__((weak)); \
+  void drawBand(uint32_t y0, uint32_t y1) __attribute__((weak)); \
 }
 
 #include "demoList.h"
@@ -29,6 +37,8 @@ namespace {
   }*/
 
   typedef void (*DemoFunc)();
+  typedef RDPDumpTest* (*DemoTestFunc)();
+  typedef void (*DemoBandFunc)(uint32_t y0, uint32_t y1);
 
   struct DemoEntry
   {
@@ -36,27 +46,193 @@ namespace {
     DemoFunc draw{};
     DemoFunc destroy{};
     const char* name{};
+    DemoTestFunc tests{};
+    DemoBandFunc drawBand{};
   };
 
+  // frames a single test-case may take in headless mode before the suite counts as stuck
+  constexpr uint32_t HEADLESS_FRAMES_PER_TEST = 8;
+
+  struct HeadlessResult
+  {
+    const char* name{};
+    RDPDumpTest::Stats stats{};
+    uint32_t testCount{};
+    uint64_t ticks{};
+    bool timeout{};
+  };
+
+  /**
+   * Headless mode, runs the test-suite of every demo one after another without any input.
+   * Results are written as JSON lines to the debug log, followed by a summary screen.
+   */
+  struct Headless
+  {
+    bool active{};
+    bool finished{};
+    uint32_t frameStart{};
+    std::vector<HeadlessResult> results{};
+  };
+
+  constexpr uint32_t TASK_SLICE_TICKS = TICKS_FROM_US(63);
+  constexpr uint32_t BEAM_FIRST_LINE = 36; // half-line of row 0, same mapping as the VI demos
+
   constinit uint64_t frameTime = 0;
+  constinit uint32_t lastLateBands = 0;
+  constinit Text::Layer::Handle frameTimeText = 0;
   constinit uint32_t currDemo = 0xFFFF;
   constinit uint32_t nextDemo = 0;
 
   volatile int freeFB = 3;
+  volatile uint32_t vblankCount = 0;
   void on_vi_frame_ready()
   {
     disable_interrupts();
     if(freeFB < 3) {
       freeFB += 1;
     }
+    ++vblankCount;
     enable_interrupts();
   }
 
+  uint32_t beamLine() {
+    return *VI_V_CURRENT & ~1;
+  }
+
+  /**
+   * Beam-racing, each band is drawn while the VI scans out the one above it and is done before its rows are read.
+   * 'Text::Layer' strings are drawn with the band they start in.
+   * Returns the bands that were late (CPU side only, RDP work is not awaited), stops once the frame is overrun.
+   */
+  uint32_t drawBands(DemoBandFunc drawBand, uint32_t frameVBlank)
+  {
+    uint32_t lateBands = 0;
+    for(uint32_t y=0; y<SCREEN_HEIGHT; y+=BEAM_BAND_HEIGHT)
+    {
+      uint32_t lineBand = BEAM_FIRST_LINE + y*2;
+      uint32_t lineReady = lineBand - BEAM_BAND_HEIGHT*2;
+      while(vblankCount == frameVBlank && beamLine() < lineReady) {
+        TaskQueue::runSlice(TASK_SLICE_TICKS);
+      }
+      if(vblankCount != frameVBlank) {
+        return lateBands + (SCREEN_HEIGHT - y) / BEAM_BAND_HEIGHT;
+      }
+
+      drawBand(y, y + BEAM_BAND_HEIGHT);
+      Text::Layer::draw(y, y + BEAM_BAND_HEIGHT);
+      if(vblankCount != frameVBlank || beamLine() >= lineBand)++lateBands;
+    }
+    return lateBands;
+  }
+
   std::vector<DemoEntry> demos{};
   uint32_t nextDemoSel = 1;
 
+  Headless headless{};
+
+  uint32_t findNextTestDemo(uint32_t idx)
+  {
+    for(uint32_t i=idx+1; i<demos.size(); ++i) {
+      if(demos[i].tests) {
+        demos[i].tests()->batchMode = true; // no need to watch, run everything in one go
+        return i;
+      }
+    }
+    return 0;
+  }
+
+  void headlessStart()
+  {
+    headless = {.active = true};
+    nextDemo = findNextTestDemo(0);
+    debugf("{\"headless\":\"start\"}\n");
+  }
+
+  void headlessFinish()
+  {
+    uint32_t passed = 0;
+    uint32_t total = 0;
+    for(auto &res : headless.results) {
+      passed += res.stats.passed;
+      total += res.testCount;
+    }
+    debugf("{\"headless\":\"done\",\"passed\":%lu,\"total\":%lu}\n", passed, total);
+
+    headless.active = false;
+    headless.finished = true;
+    nextDemo = 0;
+  }
+
+  /**
+   * Checks if the suite of the current demo is done, logs it and moves on to the next one.
+   * Must be called before demo switches are handled.
+   */
+  void headlessUpdate()
+  {
+    if(currDemo != nextDemo)return; // switch still pending
+    // aborted via the menu, or L/R switched to a demo without a suite
+    if(currDemo == 0 || !demos[currDemo].tests) {
+      debugf("{\"headless\":\"aborted\"}\n");
+      headless.active = false;
+      return;
+    }
+
+    auto tests = demos[currDemo].tests();
+    bool timeout = (state.frame - headless.frameStart) > (tests->testCases.size() * HEADLESS_FRAMES_PER_TEST);
+    if(!tests->isFinished() && !timeout)return;
+
+    HeadlessResult res{
+      .name = demos[currDemo].name,
+      .stats = tests->getStats(),
+      .testCount = (uint32_t)tests->testCases.size(),
+      .timeout = timeout,
+    };
+    for(auto &testRes : tests->testRes)res.ticks += testRes.ticks;
+
+    tests->logResults(res.name);
+    debugf("{\"suite\":\"%s\",\"passed\":%lu,\"failed\":%lu,\"noRef\":%lu,\"total\":%lu,\"us\":%lu,\"timeout\":%s}\n",
+      res.name, res.stats.passed, res.stats.failed, res.stats.noRef, res.testCount,
+      (uint32_t)TICKS_TO_US(res.ticks), res.timeout ? "true" : "false"
+    );
+    headless.results.push_back(res);
+
+    nextDemo = findNextTestDemo(currDemo);
+    if(nextDemo == 0)headlessFinish();
+  }
+
+  void headlessSummaryDraw()
+  {
+    auto press = joypad_get_buttons_pressed(JOYPAD_PORT_1);
+    if(press.a || press.b || press.start) {
+      headless.finished = false;
+    }
+
+    int posY = 32;
+    Text::print(16, posY, "Headless Test Run"); posY += 16;
+
+    for(auto &res : headless.results)
+    {
+      bool ok = !res.timeout && res.stats.passed == res.testCount;
+      Text::setColor(ok ? color_t{0x66, 0xFF, 0x66} : color_t{0xFF, 0x66, 0x66});
+      Text::print(16, posY, ok ? "OK" : (res.timeout ? "TIME" : "FAIL"));
+      Text::setColor();
+      Text::print(56, posY, res.name); posY += 9;
+
+      Text::setColor({0xBB, 0xBB, 0xBB});
+      Text::printFmt(56, posY, "%d/%d  %.2fms", res.stats.passed, res.testCount,
+        TICKS_TO_US(res.ticks) * (1.0f / 1000.0f)
+      ); posY += 12;
+      Text::setColor();
+    }
+  }
+
   void demoMenuDraw()
   {
+    if(headless.finished) {
+      headlessSummaryDraw();
+      return;
+    }
+
     // draw checkerboard pattern
     uint16_t *buff = (uint16_t*)state.fb->buffer;
     int offset = state.frame / 4;
@@ -85,6 +261,7 @@ namespace {
     if(press.a || press.b) {
       nextDemo = nextDemoSel;
     }
+    if(press.z)headlessStart();
 
     constexpr color_t colSel{0x66, 0x66, 0xFF};
 
@@ -102,6 +279,7 @@ namespace {
     Text::print(20, posY, "D-Pad/A - Select     "); posY += 9;
     Text::print(20, posY, "Start   - Open Menu  "); posY += 9;
     Text::print(20, posY, "L/R     - Toggle Demo"); posY += 9;
+    Text::print(20, posY, "Z       - Run Tests  "); posY += 9;
 
     posY += 10;
 
@@ -122,7 +300,7 @@ constinit State state{};
 [[noreturn]]
 int main()
 {
-  #define DEMO_ENTRY(X) {Demo::X::init, Demo::X::draw, Demo::X::destroy, Demo::X::name},
+  #define DEMO_ENTRY(X) {Demo::X::init, Demo::X::draw, Demo::X::destroy, Demo::X::name, Demo::X::tests, Demo::X::drawBand},
   demos = {
     DemoEntry{.draw = demoMenuDraw},
     #include "demoList.h"
@@ -133,8 +311,11 @@ int main()
   debug_init_usblog();
 
   dfs_init(DFS_DEFAULT_LOCATION);
+  bool hasRefPack = RefPack::open("rom:/tests.pack");
+  assertf(hasRefPack, "Missing or invalid test references: rom:/tests.pack");
 
   joypad_init();
+  joypad_poll();
 
   vi_init();
   vi_set_dedither(false);
@@ -146,11 +327,6 @@ int main()
 
   assertf(get_tv_type() == TV_NTSC, "Please run ROM in NTSC mode!");
 
-  disable_interrupts();
-    register_VI_handler(on_vi_frame_ready);
-    set_VI_interrupt(1, VI_V_CURRENT_VBLANK);
-  enable_interrupts();
-
   surface_t fbs[3] = {
     // Note: stride must be 0x800, since a single MI-repeat write will wrap within a 0x800 boundary
     surface_make((char*)0xA0300000, FMT_RGBA16, 320, 240, 0x800),
@@ -158,31 +334,60 @@ int main()
     surface_make((char*)0xA0400000, FMT_RGBA16, 320, 240, 0x800),
   };
 
+  // sets up the VI mode, libdragon's handler would also apply a swap on the line-interrupts started below
+  vi_show(&fbs[0]);
+  vi_wait_vblank();
+
+  // also drives the per-line VI writes of demos, 'on_vi_frame_ready' still only runs once per frame
+  VITimeline::init(on_vi_frame_ready);
+
   state.frame = 0;
+  // emulators without MI-repeat support still get a working menu
+  const bool hasMiRepeat = MiMem::isSupported();
+
+  // no controller means an unattended run (e.g. emulator CI), go through all tests
+  if(!joypad_is_connected(JOYPAD_PORT_1)) {
+    headlessStart();
+  }
 
   for(;;) 
   {
     ++state.frame;
-    if(state.tripleBuffer) {
+    // beam-racing draws into the framebuffer that is currently shown
+    bool beamRace = state.beamRacing && currDemo < demos.size() && demos[currDemo].drawBand;
+    if(state.tripleBuffer && !beamRace) {
       state.fb = &fbs[state.frame % 3];
     } else {
       state.fb = &fbs[0];
     }
 
+    if(beamRace) {
+      // bands start right after the vblank, ahead of the first visible line
+      uint32_t lastVBlank = vblankCount;
+      while(vblankCount == lastVBlank) {
+        TaskQueue::runSlice(TASK_SLICE_TICKS);
+      }
+    } else {
+      // waiting for a free framebuffer, queued tasks get the time in slices of about one scanline
+      while(freeFB == 0) {
+        if(!TaskQueue::runSlice(TASK_SLICE_TICKS))VITimeline::waitVBlank();
+      }
+      disable_interrupts();
+      freeFB -= 1;
+      enable_interrupts();
+    }
+    uint32_t frameVBlank = vblankCount;
+
+    // polled after the wait, so the input is as recent as possible
     joypad_poll();
+    state.inputTicks = get_ticks();
     auto held = joypad_get_buttons_held(JOYPAD_PORT_1);
     auto press = joypad_get_buttons_pressed(JOYPAD_PORT_1);
     if(press.r){ nextDemo = (currDemo + 1) % demos.size(); if(nextDemo == 0)nextDemo = 1; }
     if(press.l){ nextDemo = (currDemo - 1) % demos.size(); if(nextDemo == 0)nextDemo = demos.size()-1; }
     if(press.start)nextDemo = 0;
 
-    while(freeFB == 0) {
-      vi_wait_vblank();
-    }
-
-    disable_interrupts();
-    freeFB -= 1;
-    enable_interrupts();
+    if(headless.active)headlessUpdate();
 
     uint64_t t = get_ticks();
 
@@ -190,34 +395,67 @@ int main()
     state.timeInt += 50;
 
     if(currDemo != nextDemo) {
-      vi_wait_vblank();
+      // tasks may still reference the state of the old demo, or submit a VI table after the stop
+      TaskQueue::flush();
+      VITimeline::stop();
+      VITimeline::waitVBlank();
+      uint64_t ticksSwitch = get_ticks();
       state.time = 0;
       state.timeInt = 0;
       state.tripleBuffer = true;
+      state.beamRacing = false;
+      beamRace = false;
       state.showFrameTime = true;
+      state.clearsScreen = true;
 
       if(currDemo < demos.size() && demos[currDemo].destroy) {
         demos[currDemo].destroy();
       }
 
-      // clear all 3 framebuffers to black
-      for(int i=0; i<3; ++i) {
-        memset(fbs[i].buffer, 0, fbs[i].height * fbs[i].stride);
+      // clear all 3 framebuffers to black, incl. the area past the width (read by VI scaling)
+      uint64_t ticksClear = get_ticks();
+      for(auto &fb : fbs) {
+        if(hasMiRepeat) {
+          MiMem::fillRect(surface_make(fb.buffer, FMT_RGBA16, fb.stride/2, fb.height, fb.stride), 0, 0, fb.stride/2, fb.height, 0);
+        } else {
+          memset(fb.buffer, 0, fb.height * fb.stride);
+        }
       }
+      ticksClear = get_ticks() - ticksClear;
+
+      Text::Layer::removeAll();
+      frameTimeText = Text::Layer::create();
 
       currDemo = nextDemo;
+      headless.frameStart = state.frame;
       if(demos[currDemo].init)demos[currDemo].init();
+
+      debugf("{\"demoSwitch\":\"%s\",\"clearUs\":%lu,\"totalUs\":%lu}\n",
+        demos[currDemo].name ? demos[currDemo].name : "menu",
+        (uint32_t)TICKS_TO_US(ticksClear), (uint32_t)TICKS_TO_US(get_ticks() - ticksSwitch)
+      );
     }
 
     demos[currDemo].draw();
 
-    if(state.showFrameTime) {
-      Text::printf(16, 16, "%.2fms", TICKS_TO_US(frameTime) * (1.0f / 1000.0f));
+    // beam-racing draws the layer with each band, so the frame time and late bands are the ones of the last frame
+    if(state.showFrameTime && beamRace) {
+      Text::Layer::printFmt(frameTimeText, 16, 16, "%.2fms late:%lu", TICKS_TO_US(frameTime) * (1.0f / 1000.0f), lastLateBands);
+    } else if(state.showFrameTime) {
+      Text::Layer::printFmt(frameTimeText, 16, 16, "%.2fms", TICKS_TO_US(frameTime) * (1.0f / 1000.0f));
+    } else {
+      Text::Layer::print(frameTimeText, 16, 16, "");
+    }
+
+    if(state.clearsScreen)Text::Layer::invalidate();
+    if(beamRace) {
+      lastLateBands = drawBands(demos[currDemo].drawBand, frameVBlank);
+    } else {
+      Text::Layer::draw();
     }
 
     frameTime = get_ticks() - t;
 
-    vi_show(state.fb);
-    //vi_wait_vblank();
+    VITimeline::show(state.fb);
   }
 }
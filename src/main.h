@@ -8,6 +8,7 @@
 namespace {
   constexpr uint32_t SCREEN_WIDTH = 320;
   constexpr uint32_t SCREEN_HEIGHT = 240;
+  constexpr uint32_t BEAM_BAND_HEIGHT = 16; // rows per 'drawBand' call in beam-racing mode
 }
 
 struct State
@@ -16,8 +17,11 @@ struct State
   uint32_t timeInt{};
   surface_t *fb{};
   uint32_t frame{};
+  uint64_t inputTicks{}; // when the joypad was last polled
   bool tripleBuffer{true};
+  bool beamRacing{false}; // single framebuffer, drawn in bands just ahead of the scan-out (needs 'drawBand')
   bool showFrameTime{true};
+  bool clearsScreen{true}; // false: demo keeps the framebuffer content, 'Text::Layer' only draws changes
 };
 
 extern State state;
\ No newline at end of file
@@ -3,10 +3,41 @@
 * @license MIT
 */
 #include "math.h"
+#include <array>
 
 namespace {
   constexpr float pi_hi = 3.14159274f; // 0x1.921fb6p+01
   constexpr float pi_lo = -8.74227766e-08f; // -0x1.777a5cp-24
+
+  constexpr uint32_t SIN_LUT_BITS = 8;
+  constexpr uint32_t SIN_LUT_SIZE = 1 << SIN_LUT_BITS;
+  constexpr uint32_t SIN_FRAC_BITS = 32 - SIN_LUT_BITS;
+  constexpr double TWO_PI = 6.283185307179586;
+
+  // one full period, plus the first entry repeated so interpolation never needs to wrap
+  constexpr auto SIN_LUT = [] {
+    std::array<float, SIN_LUT_SIZE + 1> lut{};
+    for(uint32_t i=0; i<=SIN_LUT_SIZE; ++i) {
+      double x = TWO_PI * (i % SIN_LUT_SIZE) / SIN_LUT_SIZE;
+      if(x > TWO_PI / 2)x -= TWO_PI;
+      // Taylor series, converges to double precision well within the range of [-PI, PI]
+      double term = x, sum = x;
+      for(int n=1; n<16; ++n) {
+        term *= -x * x / ((2*n) * (2*n + 1));
+        sum += term;
+      }
+      lut[i] = (float)sum;
+    }
+    return lut;
+  }();
+
+  // angle to a fixed-point phase, where 2^32 is a full period
+  // done in double, so larger angles (e.g. scaled time) keep their fractional part
+  uint32_t toPhase(float x) {
+    double turns = x * (1.0 / TWO_PI);
+    turns -= (int64_t)turns;
+    return (uint32_t)(int64_t)(turns * 4294967296.0);
+  }
 }
 
 float Math::sinApprox(float x) {
@@ -19,4 +50,18 @@ float Math::sinApprox(float x) {
 
   x = x * ((x - pi_hi) - pi_lo) * ((x + pi_hi) + pi_lo) * p;
   return x;
-}
\ No newline at end of file
+}
+
+void Math::sinBatch(float *out, float base, float step, uint32_t count)
+{
+  constexpr float FRAC_SCALE = 1.0f / (1 << SIN_FRAC_BITS);
+  uint32_t phase = toPhase(base);
+  uint32_t phaseStep = toPhase(step);
+
+  for(uint32_t i=0; i<count; ++i) {
+    uint32_t idx = phase >> SIN_FRAC_BITS;
+    float frac = (float)(phase & ((1 << SIN_FRAC_BITS) - 1)) * FRAC_SCALE;
+    out[i] = SIN_LUT[idx] + (SIN_LUT[idx+1] - SIN_LUT[idx]) * frac;
+    phase += phaseStep;
+  }
+}
@@ -8,22 +8,77 @@ void MiMem::writeAligned(volatile uint64_t *addr, uint64_t value, int bytes)
 {
   do {
     *MI_MODE = MI_WMODE_SET_REPEAT | (bytes > 128 ? 127 : (bytes-1));
-    *addr = value;
+    #ifdef REP64_HOST
+      HostShim::miWrite(addr, &value, sizeof(value));
+    #else
+      *addr = value;
+    #endif
     bytes -= 128; // we only care about the iteration count, the size is clamped above
     addr += 128 / 8;
   } while(bytes > 0);
 }
 
 void MiMem::zeroUnaligned(const volatile char *addr, int bytes) {
-  uint32_t misalign = ((uint32_t)addr) & 0b111;
+  uint32_t misalign = ((uintptr_t)addr) & 0b111;
   bytes += misalign;
   uint64_t value = (misalign & 0b110) ? 0xAABBCCDD'FF000000 : 0;
   do {
-    asm volatile (".balign 32");
-    *MI_MODE = MI_WMODE_SET_REPEAT | (bytes > 128 ? 127 : (bytes-1));
-    //asm volatile ("sb $zero, 0(%0)\n" :: "r"(addr) : "memory");
-    asm volatile ("sb %0, 0(%1)\n" ::"r"(value), "r"(addr) : "memory");
+    #ifdef REP64_HOST
+      *MI_MODE = MI_WMODE_SET_REPEAT | (bytes > 128 ? 127 : (bytes-1));
+      uint8_t byte = value;
+      HostShim::miWrite((volatile char*)addr, &byte, 1);
+    #else
+      asm volatile (".balign 32");
+      *MI_MODE = MI_WMODE_SET_REPEAT | (bytes > 128 ? 127 : (bytes-1));
+      //asm volatile ("sb $zero, 0(%0)\n" :: "r"(addr) : "memory");
+      asm volatile ("sb %0, 0(%1)\n" ::"r"(value), "r"(addr) : "memory");
+    #endif
     bytes -= 128; // we only care about the iteration count, the size is clamped above
-    addr += 128;
+    // the repeat counts from the start of the doubleword, so continue at the aligned address
+    addr = (const volatile char*)(((uintptr_t)addr & ~0b111) + 128);
   } while(bytes > 0);
 }
+
+void MiMem::fillSpan(volatile void *addr, int width, uint16_t color)
+{
+  constexpr uint32_t WRAP_SIZE = 0x800;
+  constexpr int MIN_REPEAT_PIXELS = 8;
+
+  auto dst = (volatile uint8_t*)addr;
+  if(width < MIN_REPEAT_PIXELS) {
+    for(int i=0; i<width; ++i)((volatile uint16_t*)dst)[i] = color;
+    return;
+  }
+
+  uint64_t value = color;
+  value |= value << 16;
+  value |= value << 32;
+
+  int bytes = width * 2;
+  while(bytes > 0) {
+    int size = WRAP_SIZE - ((uintptr_t)dst & (WRAP_SIZE-1));
+    if(size > bytes)size = bytes;
+    // 'write' needs to reach the next 8-byte boundary, only a problem right before a wrap
+    if(size < 8) {
+      for(int i=0; i<size; i+=2)*(volatile uint16_t*)(dst + i) = color;
+    } else {
+      write(dst, value, size);
+    }
+    dst += size;
+    bytes -= size;
+  }
+}
+
+void MiMem::fillRect(const surface_t &surf, int x, int y, int width, int height, uint16_t color)
+{
+  if(x < 0) { width += x; x = 0; }
+  if(y < 0) { height += y; y = 0; }
+  if(x + width > surf.width)width = surf.width - x;
+  if(y + height > surf.height)height = surf.height - y;
+  if(width <= 0 || height <= 0)return;
+
+  auto row = (uint8_t*)surf.buffer + y * surf.stride + x * 2;
+  for(int l=0; l<height; ++l, row += surf.stride) {
+    fillSpan(row, width, color);
+  }
+}
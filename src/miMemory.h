@@ -11,20 +11,39 @@ namespace MiMem
   void writeAligned(volatile uint64_t *addr, uint64_t value, int bytes);
   void zeroUnaligned(const volatile char* addr, int bytes);
 
+  /**
+   * Fills a rectangle of a 16-bit surface with MI-repeat writes, clipped to the surface.
+   * Rows are split at 0x800 boundaries (a single repeat-write wraps inside them),
+   * narrow rects fall back to plain stores.
+   */
+  void fillRect(const surface_t &surf, int x, int y, int width, int height, uint16_t color);
+
+  // single row of 'width' 16-bit pixels, same splitting as 'fillRect' but without clipping
+  void fillSpan(volatile void *addr, int width, uint16_t color);
+
   inline void write(volatile void *addr, uint64_t value, int bytes)
   {
-    uint32_t misalign = ((uint32_t)addr) & 0b111;
+    uint32_t misalign = ((uintptr_t)addr) & 0b111;
     if(misalign) {
-      asm volatile ("sdl %0, 0(%1)\n" ::"r"(value), "r"(addr) : "memory");
+      #ifdef REP64_HOST
+        HostShim::storeLeft(addr, value);
+      #else
+        asm volatile ("sdl %0, 0(%1)\n" ::"r"(value), "r"(addr) : "memory");
+      #endif
       addr = (char*)addr + (8  - misalign);
       bytes -= (8  - misalign);
+      if(bytes <= 0)return; // a repeat-write would still store at least 1 byte
     }
     writeAligned((volatile uint64_t*)addr, value, bytes);
   }
 
   inline bool isSupported()
   {
-    uint64_t *addr = (uint64_t*)0xA0300000;
+    #ifdef REP64_HOST
+      auto addr = (uint64_t*)HostShim::fromPhysical(0x30'0000);
+    #else
+      uint64_t *addr = (uint64_t*)0xA0300000;
+    #endif
     addr[1] = 0xFF;
     MiMem::writeAligned(addr, 0, 16);
     return addr[1] == 0;
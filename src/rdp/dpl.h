@@ -4,6 +4,7 @@
 */
 #pragma once
 #include <libdragon.h>
+#include <array>
 #include <vector>
 #include <stdexcept>
 
@@ -49,12 +50,21 @@ namespace RDP
       return *this;
     }
 
+    template<size_t N>
+    DPL& add(const std::array<uint64_t, N> &cmds) {
+      for (auto cmd : cmds)add(cmd);
+      return *this;
+    }
+
     void runAsyncUnsafe() const {
       MEMORY_BARRIER();
       *DP_START = PhysicalAddr(dpl);
       MEMORY_BARRIER();
       *DP_END = PhysicalAddr(dplEnd);
       MEMORY_BARRIER();
+      #ifdef REP64_HOST
+        HostShim::dpSubmit();
+      #endif
     }
 
     void runAsync() const {
@@ -64,6 +74,9 @@ namespace RDP
       MEMORY_BARRIER();
       *DP_END = PhysicalAddr(dplEnd);
       MEMORY_BARRIER();
+      #ifdef REP64_HOST
+        HostShim::dpSubmit();
+      #endif
     }
 
     void await(uint64_t waitTicks = 0) {
@@ -4,6 +4,7 @@
 */
 #pragma once
 #include <libdragon.h>
+#include <array>
 #include <bit>
 #include <vector>
 
@@ -24,7 +25,11 @@ namespace
   }
 
   constexpr uint32_t addrToPhysical(void* addr) {
-    return std::bit_cast<uint32_t>(addr) & ~0xE0000000;
+    #ifdef REP64_HOST
+      return HostShim::toPhysical(addr);
+    #else
+      return std::bit_cast<uint32_t>(addr) & ~0xE0000000;
+    #endif
   }
 }
 
@@ -329,6 +334,64 @@ namespace RDP
     return setEnvColor(std::bit_cast<uint32_t>(color));
   }
 
+  constexpr uint64_t setTextureImage(void* texture, uint32_t format, uint32_t bbp, uint32_t width) {
+    return bitCmd(0x3D)
+      | bitVal(format, 55, 53)
+      | bitVal(bbp, 52, 51)
+      | bitVal(width-1, 41, 32)
+      | bitVal(addrToPhysical(texture), 25, 0);
+  }
+
+  // 'line' is the size of a texture row in TMEM in 64-bit words, no clamping/mirroring/masking
+  constexpr uint64_t setTile(uint32_t tile, uint32_t format, uint32_t bbp, uint32_t line, uint32_t tmemAddr) {
+    return bitCmd(0x35)
+      | bitVal(format, 55, 53)
+      | bitVal(bbp, 52, 51)
+      | bitVal(line, 49, 41)
+      | bitVal(tmemAddr / 8, 40, 32)
+      | bitVal(tile, 26, 24);
+  }
+
+  constexpr uint64_t loadTile(uint32_t tile, float s0, float t0, float s1, float t1) {
+    return bitCmd(0x34)
+      | bitVal(floatTo10p2(s0), 55, 44)
+      | bitVal(floatTo10p2(t0), 43, 32)
+      | bitVal(tile, 26, 24)
+      | bitVal(floatTo10p2(s1), 23, 12)
+      | bitVal(floatTo10p2(t1), 11, 0);
+  }
+
+  constexpr uint64_t setTileSize(uint32_t tile, float s0, float t0, float s1, float t1) {
+    return bitCmd(0x32)
+      | bitVal(floatTo10p2(s0), 55, 44)
+      | bitVal(floatTo10p2(t0), 43, 32)
+      | bitVal(tile, 26, 24)
+      | bitVal(floatTo10p2(s1), 23, 12)
+      | bitVal(floatTo10p2(t1), 11, 0);
+  }
+
+  /**
+   * Textured rectangle (128-bit command), 'x1'/'y1' are exclusive in 1-cycle mode.
+   * 's'/'t' are the texel coordinates of the top-left corner, 'dsdx'/'dtdy' the texel step per pixel.
+   */
+  constexpr std::array<uint64_t, 2> textureRect(
+    uint32_t tile, float x0, float y0, float x1, float y1,
+    float s, float t, float dsdx = 1.0f, float dtdy = 1.0f
+  ) {
+    return {
+      bitCmd(0x24)
+        | bitVal(floatTo10p2(x1), 55, 44)
+        | bitVal(floatTo10p2(y1), 43, 32)
+        | bitVal(tile, 26, 24)
+        | bitVal(floatTo10p2(x0), 23, 12)
+        | bitVal(floatTo10p2(y0), 11, 0),
+      bitVal((int32_t)(s * 32), 63, 48)
+        | bitVal((int32_t)(t * 32), 47, 32)
+        | bitVal((int32_t)(dsdx * 1024), 31, 16)
+        | bitVal((int32_t)(dtdy * 1024), 15, 0)
+    };
+  }
+
   TriParams triangleGen(uint32_t attrs, const Vertex &v0, const Vertex &v1, const Vertex &v2);
   std::vector<uint64_t> triangleWrite(TriParams &p, uint32_t attrs = TriAttr::POS);
 
@@ -354,6 +417,10 @@ namespace RDP
     constexpr OtherMode& cycleType(uint32_t cycleType) {
       value |= bitVal(cycleType, 53, 52); return *this;
     }
+    // texture filter outputs RGB (instead of YUV) in both cycles, needed for any non-YUV texture
+    constexpr OtherMode& texFilterRGB() {
+      value |= bitVal(0b11, 43, 42); return *this;
+    }
     constexpr OtherMode& ditherRGBA(DitherRGB dither) {
       value |= bitVal((uint32_t)dither, 39, 38); return *this;
     }
@@ -3,6 +3,8 @@
 * @license MIT
 */
 #include "rdpDumpTest.h"
+#include "testRegion.h"
+#include "refPack.h"
 #include "main.h"
 #include "rdp/rdp.h"
 #include "rdp/dpl.h"
@@ -13,6 +15,8 @@ namespace
 {
 }
 
+surface_t RDPDumpTest::scratchSurface{};
+
 void RDPDumpTest::run(std::function<void(uint32_t)> fn)
 {
    // detect if we are crashed
@@ -23,62 +27,101 @@ void RDPDumpTest::run(std::function<void(uint32_t)> fn)
 
     wait_ticks(TICKS_FROM_US(250));
 
-    if(*DP_STATUS & DP_STATUS_PIPE_BUSY)
+    if(isRDPBusy())
     {
       int posY = 64;
       Text::setColor({0xFF, 0x22, 0x22});
-      Text::printf(64, posY, "!!! RDP HAS CRASHED !!!"); posY += 8;
+      Text::print(64, posY, "!!! RDP HAS CRASHED !!!"); posY += 8;
       Text::setColor();
-      Text::printf(64, posY, "Please Power Cycle"); posY += 16;
+      Text::print(64, posY, "Please Power Cycle"); posY += 16;
 
-      Text::printf(64, posY, "DP_CLCK: %08X", *DP_CLOCK); posY += 8;
-      Text::printf(64, posY, "DP_BUSY: %08X", *DP_BUSY); posY += 8;
-      Text::printf(64, posY, "DP_CURR: %08X", *DP_CURRENT); posY += 8;
-      Text::printf(64, posY, "DP_END : %08X", *DP_END); posY += 8;
+      Text::printFmt(64, posY, "DP_CLCK: %08X", *DP_CLOCK); posY += 8;
+      Text::printFmt(64, posY, "DP_BUSY: %08X", *DP_BUSY); posY += 8;
+      Text::printFmt(64, posY, "DP_CURR: %08X", *DP_CURRENT); posY += 8;
+      Text::printFmt(64, posY, "DP_END : %08X", *DP_END); posY += 8;
       return;
     }
 
-    uint32_t testDoneCount = 0;
-    uint32_t testSuccessCount = 0;
-    for(auto res : testRes) {
-      if(res != 0xFFFF'FFFF)++testDoneCount;
-      testSuccessCount += res == 0 ? 1 : 0;
-    }
-    if(testDoneCount == testCases.size()) {
+    if(testCases.empty())return;
+
+    auto stats = getStats();
+    if(stats.done == testCases.size()) {
       autoMode = false;
     }
 
     auto held = joypad_get_inputs(JOYPAD_PORT_1);
     auto pressed = joypad_get_buttons_pressed(JOYPAD_PORT_1);
 
+    if(allowSweep && pressed.z) {
+      addSeeds(testCases.back(), SWEEP_SIZE);
+    }
+    if(pressed.a) {
+      batchMode = !batchMode;
+      reset();
+    }
+
     if(pressed.c_right || pressed.d_right)++testIdx;
     if(pressed.c_left || pressed.d_left)testIdx = (testIdx + testCases.size() - 1) % testCases.size();
+    if(pressed.c_down || pressed.d_down)testIdx += PAGE_SIZE;
+    if(pressed.c_up || pressed.d_up)testIdx = (testIdx + testCases.size() - (PAGE_SIZE % testCases.size())) % testCases.size();
+
+    if(batchMode) {
+      testIdx = testIdx % testCases.size();
+      if(autoMode)runBatch(fn);
+
+      RDP::DPL dpl{8};
+      dpl.add(RDP::syncPipe())
+        .add(RDP::setColorImage(state.fb->buffer, RDP::Format::RGBA, RDP::BBP::_16, state.fb->stride/2))
+        .add(RDP::setScissor(0, 0, state.fb->width-1, state.fb->height-1))
+        .add(RDP::setOtherModes(RDP::OtherMode().cycleType(RDP::CYCLE::FILL)))
+        .add(RDP::setFillColor({0, 0, 0, 0}))
+        .add(RDP::fillRect(0, 0, state.fb->width-1, state.fb->height-1))
+        .runSync();
+
+      drawResults(getStats());
+      if(batchTicks) {
+        Text::setColor({0xBB, 0xBB, 0xBB});
+        Text::printFmt(16, 180, "Batch: %.2fms", TICKS_TO_US(batchTicks) * (1.0f / 1000.0f));
+        Text::setColor();
+      }
+      return;
+    }
+
     if(autoMode)testIdx++;
     testIdx = testIdx % testCases.size();
 
+    runCase(fn, testIdx, pressed.b);
+    drawResults(getStats());
 
-    fn(testCases[testIdx]);
-
-    // Load referende file
-    const char* filePath = "rom:/00000000.test";
-    sprintf((const_cast<char*>(filePath) + 5), "%08lX.test", testCases[testIdx]);
+    wait_ms(5);
+}
 
-    uint16_t *testDataOrg = nullptr;
+void RDPDumpTest::runCase(const std::function<void(uint32_t)> &fn, uint32_t idx, bool forceDump)
+{
+    uint64_t ticksStart = get_ticks();
+    fn(testCases[idx]);
 
-    // comment-in to avoid testing:
-    testDataOrg = (uint16_t *)asset_load(filePath, nullptr);
+    // Load reference from the test-pack, only the compressed data is read
+    auto refEntry = RefPack::find(testCases[idx]);
+    uint16_t *testDataOrg = refEntry ? RefPack::load(*refEntry) : nullptr;
+    RefPack::Reader testData{testDataOrg, testDataOrg ? testDataOrg + refEntry->size / 2 : nullptr};
+    if(refEntry && !testDataOrg)debugf("RDPDumpTest: could not read the reference of %08lX\n", testCases[idx]);
 
-    auto testData = testDataOrg ? testDataOrg : (uint16_t*)&testCases;
+    uint32_t regionPixels = (testRegion[2] - testRegion[0] + 1) * (testRegion[3] - testRegion[1]);
+    assertf(!testDataOrg || RefPack::getPixelCount() == regionPixels,
+      "RDPDumpTest: references have %lu pixels, the test-region %lu", RefPack::getPixelCount(), regionPixels
+    );
 
-    bool isDump = pressed.b;
-    if(isDump)debugf("TEST=%08X\n", testCases[testIdx]);
+    // missing references are dumped once, so sweeps can be turned into new references
+    bool isDump = forceDump || (!testDataOrg && testRes[idx].status == Status::PENDING);
+    if(isDump)debugf("TEST=%08X\n", testCases[idx]);
 
     // go pixel by pixel in the test region and compare
     // if pressed B, dump the framebuffer over debugf
     uint16_t* fbPtr = (uint16_t*)state.fb->buffer;
     fbPtr += testRegion[1] * (state.fb->stride / 2);
 
-    testRes[testIdx] = 0;
+    uint32_t errors = 0;
     int totalPixel = 0;
 
     for(int y=testRegion[1]; y<testRegion[3]; ++y)
@@ -88,9 +131,10 @@ void RDPDumpTest::run(std::function<void(uint32_t)> fn)
         uint16_t col = fbPtr[x];
         if(isDump)debugf("%04X", col);
 
-        testRes[testIdx] += (*testData != col) ? 1 : 0;
-        ++testData;
-        totalPixel += (col == 0x2108) ? 0 : 1; // ignore BG pixels
+        if(testDataOrg) {
+          errors += (testData.next() != col) ? 1 : 0;
+        }
+        totalPixel += (col == TestRegion::BG_COLOR) ? 0 : 1; // ignore BG pixels
       }
       fbPtr += (state.fb->stride / 2);
       if(isDump)debugf("\n");
@@ -98,46 +142,162 @@ void RDPDumpTest::run(std::function<void(uint32_t)> fn)
 
     if(testDataOrg)free(testDataOrg);
 
-    // prints results per test at the bottom
-    int py = 200;
-    int px = 16;
-    Text::printf(px, py, "Errors:         (Test: %02d|%08X)", testIdx, testCases[testIdx]);
-    py+=10;
-    for(uint32_t t=0; t<testCases.size(); ++t)
+    auto &res = testRes[idx];
+    res.ticks = get_ticks() - ticksStart;
+    res.errors = errors > 0xFFFF ? 0xFFFF : errors;
+    if(!testDataOrg) {
+      res.status = Status::NO_REF;
+    } else {
+      res.status = errors == 0 ? Status::PASS : Status::FAIL;
+    }
+}
+
+void RDPDumpTest::runBatch(const std::function<void(uint32_t)> &fn)
+{
+  // allocated on first use and kept, same 0x800 stride (and alignment) as the framebuffers in main.cpp
+  if(!scratchSurface.buffer) {
+    void* buff = malloc_uncached_aligned(0x800, 0x800 * SCREEN_HEIGHT);
+    assertf(buff, "RDPDumpTest: no memory for the scratch surface");
+    scratchSurface = surface_make(buff, FMT_RGBA16, SCREEN_WIDTH, SCREEN_HEIGHT, 0x800);
+  }
+
+  surface_t *fbVisible = state.fb;
+  state.fb = &scratchSurface;
+
+  uint64_t ticksStart = get_ticks();
+  for(uint32_t t=0; t<testCases.size(); ++t)
+  {
+    if(testRes[t].status != Status::PENDING)continue;
+    runCase(fn, t, false);
+
+    // a case that crashed the RDP timed out in runSync(), all following ones would too
+    if(isRDPBusy())break;
+  }
+  batchTicks = get_ticks() - ticksStart;
+
+  state.fb = fbVisible;
+  autoMode = false;
+}
+
+bool RDPDumpTest::isRDPBusy()
+{
+  return *DP_STATUS & DP_STATUS_PIPE_BUSY;
+}
+
+void RDPDumpTest::addSeeds(uint32_t seed, uint32_t count)
+{
+  testCases.reserve(testCases.size() + count);
+  for(uint32_t i=0; i<count; ++i) {
+    seed ^= (seed << 13);
+    seed ^= (seed >> 17);
+    seed ^= (seed << 5);
+    testCases.push_back(seed);
+  }
+  testRes.resize(testCases.size());
+  autoMode = true;
+}
+
+void RDPDumpTest::logResults(const char* suiteName) const
+{
+  constexpr const char* STATUS_NAMES[] = {"pending", "pass", "fail", "no-ref"};
+
+  for(uint32_t t=0; t<testCases.size(); ++t)
+  {
+    const auto &res = testRes[t];
+    debugf("{\"suite\":\"%s\",\"case\":\"%08lX\",\"status\":\"%s\",\"errors\":%d,\"us\":%lu}\n",
+      suiteName, testCases[t], STATUS_NAMES[(int)res.status], res.errors, (uint32_t)TICKS_TO_US(res.ticks)
+    );
+  }
+}
+
+RDPDumpTest::Stats RDPDumpTest::getStats() const
+{
+  Stats stats{};
+  for(auto &res : testRes) {
+    if(res.status == Status::PENDING)continue;
+    ++stats.done;
+    switch(res.status) {
+      case Status::PASS  : ++stats.passed; break;
+      case Status::NO_REF: ++stats.noRef;  break;
+      default:
+        ++stats.failed;
+        stats.mismatches += res.errors;
+      break;
+    }
+  }
+  return stats;
+}
+
+void RDPDumpTest::drawResults(const Stats &stats)
+{
+  uint32_t testCount = testCases.size();
+  uint32_t pageCount = (testCount + PAGE_SIZE - 1) / PAGE_SIZE;
+  uint32_t page = testIdx / PAGE_SIZE;
+
+  // prints results of the current page at the bottom
+  int py = 200;
+  int px = 16;
+  Text::printFmt(px, py, "Errors:         (Test: %02d|%08X)", testIdx, testCases[testIdx]);
+  if(pageCount > 1) {
+    Text::setColor({0x99, 0x99, 0x99});
+    Text::printFmt(px + 56, py, "%d/%d", page+1, pageCount);
+    Text::setColor();
+  }
+  py+=10;
+
+  uint32_t tEnd = (page+1) * PAGE_SIZE;
+  if(tEnd > testCount)tEnd = testCount;
+
+  for(uint32_t t=page*PAGE_SIZE; t<tEnd; ++t)
+  {
+    const auto &res = testRes[t];
+    switch(res.status)
     {
-      if(testRes[t] == 0xFFFF'FFFF) {
+      case Status::PENDING:
         Text::setColor({0x99, 0x99, 0x99});
-        Text::printf(px, py, "---");
-      } else {
+        Text::print(px, py, "---");
+      break;
+      case Status::NO_REF:
+        Text::setColor({0xFF, 0xFF, 0x66});
+        Text::print(px, py, "???");
+      break;
+      default:
         Text::setColor(
-          testRes[t] == 0 ? color_t{0x66, 0xFF, 0x66} : color_t{0xFF, 0x66, 0x66}
+          res.status == Status::PASS ? color_t{0x66, 0xFF, 0x66} : color_t{0xFF, 0x66, 0x66}
         );
-        Text::printf(px, py, "%03X", testRes[t]);
-      }
-      Text::setColor();
-      px += 28;
-      if((t+1) % 10 == 0) {
-        py+=8;
-        px = 16;
-      }
+        Text::printFmt(px, py, "%03X", res.errors);
+      break;
+    }
+    Text::setColor();
+    px += 28;
+    if((t+1) % PAGE_COLUMNS == 0) {
+      py+=8;
+      px = 16;
     }
+  }
 
-    // Test results on top
-    py = 32;
-    if(testDoneCount == testCases.size()) {
-      Text::printf(16, py, "Passed: %d/%d", testSuccessCount, testCases.size());
-      px = 128;
-      if(testSuccessCount == testCases.size()) {
-        Text::setColor({0x66, 0xFF, 0x66});
-        Text::print(px, py, "OK");
-      } else {
-        Text::setColor({0xFF, 0x66, 0x66});
-        Text::print(px, py, "FAIL!");
-      }
+  // Test results on top
+  py = 32;
+  if(stats.done == testCount) {
+    // 'print' returns the start plus the characters printed
+    int len = Text::printFmt(16, py, "Passed: %d/%d", stats.passed, testCount) - 16;
+    px = 16 + (len + 1) * 8;
+    if(stats.passed == testCount) {
+      Text::setColor({0x66, 0xFF, 0x66});
+      Text::print(px, py, "OK");
     } else {
-      Text::print(16, py, "Test running...");
+      Text::setColor({0xFF, 0x66, 0x66});
+      Text::print(px, py, "FAIL!");
     }
-    Text::setColor();
+  } else {
+    Text::printFmt(16, py, "Test running... %d/%d", stats.done, testCount);
+  }
+  Text::setColor();
 
-    wait_ms(5);
+  if(stats.failed || stats.noRef) {
+    py += 8;
+    Text::setColor({0xBB, 0xBB, 0xBB});
+    Text::printFmt(16, py, "Fail: %d  Pixel: %d  No-Ref: %d", stats.failed, stats.mismatches, stats.noRef);
+    Text::setColor();
+  }
 }
@@ -5,27 +5,90 @@
 #pragma once
 #include <libdragon.h>
 #include <array>
+#include <vector>
 #include <functional>
 
 class RDPDumpTest
 {
-  private:
-    constexpr static int TEST_CASE_COUNT = 20;
-
   public:
+    // results shown per page, drawn as rows of PAGE_COLUMNS cells
+    constexpr static uint32_t PAGE_SIZE = 20;
+    constexpr static uint32_t PAGE_COLUMNS = 10;
+    // amount of seeds appended per sweep request (Z-button)
+    constexpr static uint32_t SWEEP_SIZE = 100;
+
+    enum class Status : uint8_t {
+      PENDING = 0,
+      PASS,
+      FAIL,
+      NO_REF, // no reference found, framebuffer gets dumped instead
+    };
+
+    // compact per-case result, 8 bytes per test
+    struct Result {
+      uint32_t ticks{};  // time to render and compare the case
+      uint16_t errors{}; // mismatching pixels, saturates at 0xFFFF
+      Status status{Status::PENDING};
+    };
+
+    struct Stats {
+      uint32_t done{};
+      uint32_t passed{};
+      uint32_t failed{};
+      uint32_t noRef{};
+      uint32_t mismatches{}; // total mismatching pixels across all failed tests
+    };
+
     uint32_t testIdx = 0;
     bool autoMode = false;
+    bool allowSweep = false; // if set, test-cases are seeds and Z appends more of them
+    bool batchMode = false; // runs all cases in one frame into a scratch buffer (toggle: A)
 
-    std::array<uint32_t, TEST_CASE_COUNT> testCases{};
-    std::array<uint32_t, TEST_CASE_COUNT> testRes{};
+    std::vector<uint32_t> testCases{};
+    std::vector<Result> testRes{};
     std::array<int, 4> testRegion{0,0,0,0};
+    uint64_t batchTicks{}; // duration of the last batch run
 
     void reset()
     {
       testIdx = 0;
       autoMode = true;
-      testRes.fill(0xFFFF'FFFF);
+      testRes.assign(testCases.size(), Result{});
     }
 
+    /**
+     * Appends 'count' new test-cases, derived via xorshift from 'seed'.
+     * Results for existing cases are kept.
+     */
+    void addSeeds(uint32_t seed, uint32_t count);
+
+    Stats getStats() const;
+
+    bool isFinished() const {
+      return !testCases.empty() && getStats().done == testCases.size();
+    }
+
+    /**
+     * Writes all results as JSON lines to the debug log, one object per case.
+     * @param suiteName name reported in each line, usually the demo name
+     */
+    void logResults(const char* suiteName) const;
+
     void run(std::function<void(uint32_t)> fn);
+
+  private:
+    // offscreen target for batch-mode, shared by all suites (allocated by the first batch run)
+    static surface_t scratchSurface;
+
+    static bool isRDPBusy();
+
+    void runCase(const std::function<void(uint32_t)> &fn, uint32_t idx, bool forceDump);
+
+    /**
+     * Renders and compares all pending cases back to back into 'scratchSurface'.
+     * The render functions get the scratch buffer through 'state.fb', so they work unchanged.
+     */
+    void runBatch(const std::function<void(uint32_t)> &fn);
+
+    void drawResults(const Stats &stats);
 };
@@ -0,0 +1,90 @@
+/**
+* @copyright 2025 - Max Bebök
+* @license MIT
+*/
+#include "refPack.h"
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+  constexpr uint32_t PACK_MAGIC = 0x52363454; // 'R64T'
+  constexpr uint16_t PACK_VERSION = 1;
+
+  struct Header {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t entryCount;
+    uint32_t pixelCount;
+    uint32_t reserved;
+  };
+
+  constinit FILE *packFile{nullptr};
+  constinit uint32_t pixelCount{0};
+  std::vector<RefPack::Entry> entries{};
+}
+
+bool RefPack::open(const char *path)
+{
+  close();
+  packFile = fopen(path, "rb");
+  if(!packFile)return false;
+
+  Header header{};
+  bool valid = fread(&header, sizeof(header), 1, packFile) == 1
+    && header.magic == PACK_MAGIC && header.version == PACK_VERSION;
+
+  if(valid) {
+    entries.resize(header.entryCount);
+    valid = fread(entries.data(), sizeof(Entry), entries.size(), packFile) == entries.size();
+  }
+
+  // all entries must be within the file, so 'load' never reads past its end
+  long fileSize = (valid && fseek(packFile, 0, SEEK_END) == 0) ? ftell(packFile) : -1;
+  for(uint32_t i=0; valid && i<entries.size(); ++i) {
+    auto &e = entries[i];
+    valid = fileSize > 0 && e.offset <= (uint32_t)fileSize && e.size <= (uint32_t)fileSize - e.offset;
+  }
+
+  if(!valid) {
+    debugf("RefPack: invalid test-pack %s (%08lX v%d)\n", path, header.magic, header.version);
+    close();
+    return false;
+  }
+  pixelCount = header.pixelCount;
+  return true;
+}
+
+void RefPack::close()
+{
+  if(packFile)fclose(packFile);
+  packFile = nullptr;
+  pixelCount = 0;
+  entries.clear();
+}
+
+uint32_t RefPack::getPixelCount()
+{
+  return pixelCount;
+}
+
+const RefPack::Entry* RefPack::find(uint32_t id)
+{
+  auto it = std::lower_bound(entries.begin(), entries.end(), id, [](const Entry &e, uint32_t id) {
+    return e.id < id;
+  });
+  return (it != entries.end() && it->id == id) ? &(*it) : nullptr;
+}
+
+uint16_t* RefPack::load(const Entry &entry)
+{
+  if(!packFile)return nullptr;
+  auto data = (uint16_t*)malloc(entry.size);
+  if(!data)return nullptr;
+
+  if(fseek(packFile, entry.offset, SEEK_SET) != 0 || fread(data, 1, entry.size, packFile) != entry.size) {
+    free(data);
+    return nullptr;
+  }
+  return data;
+}
@@ -0,0 +1,60 @@
+/**
+* @copyright 2025 - Max Bebök
+* @license MIT
+*/
+#pragma once
+#include <libdragon.h>
+
+/**
+ * Access to the single test-reference pack (see tools/packTests.mjs for the layout).
+ * The pack is opened once, single entries are then read on demand.
+ */
+namespace RefPack
+{
+  struct Entry {
+    uint32_t id;
+    uint32_t offset;
+    uint32_t size; // compressed size in bytes
+  };
+
+  // returns false if the file is missing, unreadable or not a valid pack
+  bool open(const char* path);
+  void close();
+
+  // pixels per reference, all entries share the same size
+  uint32_t getPixelCount();
+
+  const Entry* find(uint32_t id);
+
+  /**
+   * Reads the compressed data of an entry ('entry.size' bytes), must be freed by the caller.
+   * Returns nullptr if it could not be read.
+   */
+  uint16_t* load(const Entry &entry);
+
+  /**
+   * Streaming decoder for loaded entry data, returns one pixel per call.
+   * Never reads past 'end', pixels after the data (e.g. of a corrupt entry) are returned as 0.
+   */
+  struct Reader
+  {
+    const uint16_t *data{};
+    const uint16_t *end{};
+    uint32_t count{};
+    uint16_t value{};
+    bool isRun{};
+
+    uint16_t next() {
+      if(count == 0) {
+        if(data == end)return 0;
+        uint16_t header = *data++;
+        isRun = header & 0x8000;
+        count = (header & 0x7FFF) + 1;
+        if(isRun)value = data != end ? *data++ : 0;
+      }
+      --count;
+      if(isRun)return value;
+      return data != end ? *data++ : 0;
+    }
+  };
+}
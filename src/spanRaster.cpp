@@ -0,0 +1,89 @@
+/**
+* @copyright 2025 - Max Bebök
+* @license MIT
+*/
+#include "spanRaster.h"
+#include "miMemory.h"
+#include <climits>
+#include <cmath>
+
+namespace
+{
+  constinit SpanRaster::Span convexBuff[SpanRaster::MAX_ROWS]{};
+
+  // first pixel/row whose center is at or after 'pos'
+  int toPixel(float pos) {
+    pos = ceilf(pos - 0.5f);
+    if(pos < INT16_MIN)return INT16_MIN;
+    if(pos > INT16_MAX)return INT16_MAX;
+    return (int)pos;
+  }
+}
+
+int SpanRaster::convexSpans(const Point *pts, int count, int maxRows, Span *spans, int &firstRow)
+{
+  firstRow = 0;
+  if(count < 3)return 0;
+
+  float minY = pts[0].y, maxY = pts[0].y;
+  for(int i=1; i<count; ++i) {
+    if(pts[i].y < minY)minY = pts[i].y;
+    if(pts[i].y > maxY)maxY = pts[i].y;
+  }
+
+  int rowStart = toPixel(minY);
+  int rowEnd = toPixel(maxY);
+  if(rowStart < 0)rowStart = 0;
+  if(rowEnd > maxRows)rowEnd = maxRows;
+  if(rowEnd <= rowStart)return 0;
+
+  int rows = rowEnd - rowStart;
+  for(int r=0; r<rows; ++r)spans[r] = {INT16_MAX, INT16_MIN};
+
+  // a convex shape crosses each row exactly twice, the left edge gives the min. and the right one the max.
+  for(int i=0; i<count; ++i)
+  {
+    Point a = pts[i];
+    Point b = pts[(i + 1) % count];
+    if(a.y == b.y)continue;
+    if(a.y > b.y) { Point t = a; a = b; b = t; }
+
+    float dxdy = (b.x - a.x) / (b.y - a.y);
+    int r0 = toPixel(a.y);
+    int r1 = toPixel(b.y);
+    if(r0 < rowStart)r0 = rowStart;
+    if(r1 > rowEnd)r1 = rowEnd;
+
+    for(int r=r0; r<r1; ++r) {
+      int16_t x = toPixel(a.x + (r + 0.5f - a.y) * dxdy);
+      Span &span = spans[r - rowStart];
+      if(x < span.x0)span.x0 = x;
+      if(x > span.x1)span.x1 = x;
+    }
+  }
+
+  firstRow = rowStart;
+  return rows;
+}
+
+void SpanRaster::fillSpans(const surface_t &surf, int y, const Span *spans, int count, uint16_t color)
+{
+  if(y < 0) { spans -= y; count += y; y = 0; }
+  if(y + count > surf.height)count = surf.height - y;
+
+  auto row = (uint8_t*)surf.buffer + y * surf.stride;
+  for(int l=0; l<count; ++l, row += surf.stride)
+  {
+    int x0 = spans[l].x0 < 0 ? 0 : spans[l].x0;
+    int x1 = spans[l].x1 > surf.width ? surf.width : spans[l].x1;
+    if(x1 > x0)MiMem::fillSpan(row + x0 * 2, x1 - x0, color);
+  }
+}
+
+void SpanRaster::fillConvex(const surface_t &surf, const Point *pts, int count, uint16_t color)
+{
+  int maxRows = surf.height < MAX_ROWS ? surf.height : MAX_ROWS;
+  int firstRow;
+  int rows = convexSpans(pts, count, maxRows, convexBuff, firstRow);
+  fillSpans(surf, firstRow, convexBuff, rows, color);
+}
@@ -0,0 +1,38 @@
+/**
+* @copyright 2025 - Max Bebök
+* @license MIT
+*/
+#pragma once
+#include <libdragon.h>
+
+/**
+ * CPU rasterizer for filled shapes on 16-bit surfaces, each row is a single MI-repeat run.
+ * Rows are split at 0x800 boundaries (see 'MiMem::fillSpan'), so any stride works.
+ */
+namespace SpanRaster
+{
+  constexpr int MAX_ROWS = 480;
+
+  // pixels [x0, x1) of a single row
+  struct Span {
+    int16_t x0{};
+    int16_t x1{};
+  };
+
+  struct Point {
+    float x{};
+    float y{};
+  };
+
+  /**
+   * Spans of a convex polygon (any winding), using pixel-center sampling like the RDP.
+   * Rows are clipped to [0, 'maxRows'), 'firstRow' is set to the row of 'spans[0]'.
+   * Returns the amount of rows written to 'spans' (at most 'maxRows').
+   */
+  int convexSpans(const Point *pts, int count, int maxRows, Span *spans, int &firstRow);
+
+  // fills 'count' rows starting at row 'y', spans are clipped to the surface
+  void fillSpans(const surface_t &surf, int y, const Span *spans, int count, uint16_t color);
+
+  void fillConvex(const surface_t &surf, const Point *pts, int count, uint16_t color);
+}
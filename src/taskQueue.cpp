@@ -0,0 +1,48 @@
+/**
+* @copyright 2025 - Max Bebök
+* @license MIT
+*/
+#include "taskQueue.h"
+
+namespace
+{
+  constinit TaskQueue::Task tasks[TaskQueue::MAX_TASKS]{};
+  constinit uint32_t head{};
+  constinit uint32_t count{};
+}
+
+bool TaskQueue::push(Task task)
+{
+  if(count == MAX_TASKS)return false;
+  tasks[(head + count) % MAX_TASKS] = task;
+  ++count;
+  return true;
+}
+
+bool TaskQueue::runSlice(uint32_t budgetTicks)
+{
+  uint64_t deadline = get_ticks() + budgetTicks;
+  while(count) {
+    if(tasks[head](deadline)) {
+      head = (head + 1) % MAX_TASKS;
+      --count;
+    }
+    if(get_ticks() >= deadline)break;
+  }
+  return count != 0;
+}
+
+void TaskQueue::flush()
+{
+  while(count) {
+    if(tasks[head](UINT64_MAX)) {
+      head = (head + 1) % MAX_TASKS;
+      --count;
+    }
+  }
+}
+
+uint32_t TaskQueue::pending()
+{
+  return count;
+}
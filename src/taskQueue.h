@@ -0,0 +1,36 @@
+/**
+* @copyright 2025 - Max Bebök
+* @license MIT
+*/
+#pragma once
+#include <libdragon.h>
+
+/**
+ * Cooperative queue of small tasks, drained in bounded slices while the main loop would otherwise wait
+ * (e.g. for a free framebuffer). Tasks run with interrupts enabled, so VI line-interrupts keep their timing.
+ * Only meant for the main loop, not for interrupts.
+ */
+namespace TaskQueue
+{
+  constexpr uint32_t MAX_TASKS = 16;
+
+  /**
+   * Called until it returns true (done), in FIFO order.
+   * Longer tasks should split their work and return false once 'get_ticks()' passes 'deadline'.
+   */
+  using Task = bool(*)(uint64_t deadline);
+
+  // returns false if the queue is full
+  bool push(Task task);
+
+  /**
+   * Runs tasks until 'budgetTicks' are used up or the queue is empty, at least one task is always called.
+   * Returns true if tasks are left.
+   */
+  bool runSlice(uint32_t budgetTicks);
+
+  // runs everything to completion, e.g. before the results of the tasks are needed
+  void flush();
+
+  uint32_t pending();
+}
@@ -0,0 +1,94 @@
+/**
+* @copyright 2025 - Max Bebök
+* @license MIT
+*/
+#pragma once
+#include <cstdint>
+#include <array>
+
+/**
+ * Seed based generation of the RDP test-cases.
+ * Shared by the demos and the host tools (tools/host), so it must not depend on libdragon.
+ */
+namespace TestGen
+{
+  struct XorShift
+  {
+    uint32_t seed;
+
+    uint32_t next() {
+      seed ^= (seed << 13);
+      seed ^= (seed >> 17);
+      seed ^= (seed << 5);
+      return seed;
+    }
+
+    // [-1, 1)
+    float nextSigned() {
+      return ((next() & 0xFFFF) / 32768.0f) - 1.0f;
+    }
+
+    // [0, 1]
+    float nextUnit() {
+      return ((next() & 0xFFFF) / (float)0xFFFF);
+    }
+  };
+
+  struct FillTri {
+    float pos[3][2];
+    uint32_t fillColor;
+  };
+
+  struct UndefShadeTri {
+    float pos[3][2];
+  };
+
+  constexpr std::array<uint32_t, 20> FILL_TRI_SEEDS{
+    0x73bfd1a2u, 0x3809113eu, 0x17d6a1e3u, 0x392df0aau, 0x0f4529b0u,
+    0x38bb9993u, 0x8216fc78u, 0x06868e65u, 0x255206b1u, 0x59b323c8u,
+    0x6f2489a4u, 0xa2aaae1du, 0xb6a33922u, 0x0a5212bbu, 0xf2dcebddu,
+    0xe58b24beu, 0x7be66493u, 0x9f605ee7u, 0x336a3a0au, 0xa3a56459u,
+  };
+
+  constexpr std::array<uint32_t, 20> UNDEF_SHADE_SEEDS{
+    0x949db639u, 0x79e6622eu, 0xbff1a7abu, 0xb97daba5u, 0xf029c740u,
+    0xc221ef19u, 0x3e5e8f05u, 0x40cb07a2u, 0x32c9921au, 0x84f09d97u,
+    0x77107f77u, 0x63a04322u, 0x2804ac62u, 0x3419e23au, 0x33fd636fu,
+    0x563c6060u, 0x856d5300u, 0xdf19d3cfu, 0x1fc4b690u, 0x5c2f3fceu,
+  };
+
+  /**
+   * Triangle around the screen center, drawn in fill-mode with a raw 32bit fill-color.
+   */
+  inline FillTri fillTri(uint32_t seed)
+  {
+    XorShift rng{seed};
+    FillTri tri{};
+    for(auto &p : tri.pos) {
+      p[0] = rng.nextSigned() * 150.0f;
+      p[1] = rng.nextSigned() * 150.0f;
+    }
+    for(auto &p : tri.pos) {
+      p[0] += 320 / 2.0f;
+      p[1] += 240 / 2.0f;
+    }
+    tri.fillColor = rng.next();
+    return tri;
+  }
+
+  /**
+   * Triangle partially off-screen, drawn without any shade attributes.
+   */
+  inline UndefShadeTri undefShadeTri(uint32_t seed)
+  {
+    XorShift rng{seed};
+    UndefShadeTri tri{};
+    tri.pos[0][0] = rng.nextUnit() * 250.0f - 100.0f;
+    tri.pos[0][1] = rng.nextUnit() * 360.0f;
+    tri.pos[1][0] = rng.nextUnit() * 450.0f;
+    tri.pos[1][1] = rng.nextUnit() * 260.0f;
+    tri.pos[2][0] = rng.nextUnit() * 450.0f;
+    tri.pos[2][1] = rng.nextUnit() * 360.0f;
+    return tri;
+  }
+}
@@ -0,0 +1,28 @@
+/**
+* @copyright 2025 - Max Bebök
+* @license MIT
+*/
+#pragma once
+#include <cstdint>
+#include <array>
+
+/**
+ * Screen region compared by the RDP dump-tests.
+ * Shared with the host tools (tools/host), so it must not depend on libdragon.
+ */
+namespace TestRegion
+{
+  constexpr int X0 = 16;
+  constexpr int Y0 = 48;
+  constexpr int X1 = 320 - 16; // inclusive
+  constexpr int Y1 = 240 - 48; // exclusive
+
+  constexpr int WIDTH = X1 - X0 + 1;
+  constexpr int HEIGHT = Y1 - Y0;
+  constexpr int PIXEL_COUNT = WIDTH * HEIGHT;
+
+  // background the tests clear the region to before drawing
+  constexpr uint16_t BG_COLOR = 0x2108;
+
+  constexpr std::array<int, 4> RECT{X0, Y0, X1, Y1};
+}
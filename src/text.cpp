@@ -6,12 +6,32 @@
 #include "main.h"
 #include "text.h"
 #include "miMemory.h"
+#include "rdp/rdp.h"
+#include "rdp/dpl.h"
+#include <array>
+#include <cstring>
 
 namespace {
   constexpr uint32_t FMT_BUFF_SIZE = 128;
 
+  // 4 pixels for each 4-bit row-chunk of a glyph, bit 0 is the left-most pixel
+  constexpr std::array<uint64_t, 16> buildColorLUT(uint16_t color)
+  {
+    std::array<uint64_t, 16> lut{};
+    uint64_t col = color;
+    for(uint32_t i=0; i<16; ++i) {
+      lut[i] = ((i & 0b0001) ? (col << 48) : 0)
+             | ((i & 0b0010) ? (col << 32) : 0)
+             | ((i & 0b0100) ? (col << 16) : 0)
+             | ((i & 0b1000) ? (col <<  0) : 0);
+    }
+    return lut;
+  }
+
   constinit int fbStride = 0x800;
   constinit uint16_t currColor = 0xFFFF;
+  constinit uint32_t currColorRGBA = 0xFFFF'FFFF;
+  constinit std::array<uint64_t, 16> colorLUT = buildColorLUT(0xFFFF);
   constinit uint8_t ignoreChar = 0;
 
   #include "font.h"
@@ -25,13 +45,16 @@ void Text::setSpaceHidden(bool hidden)
 
 void Text::setColor(color_t color)
 {
-  currColor = color_to_packed16(color);
+  currColorRGBA = color_to_packed32(color);
+  uint16_t newColor = color_to_packed16(color);
+  if(newColor == currColor)return;
+  currColor = newColor;
+  colorLUT = buildColorLUT(newColor);
 }
 
 int Text::print(int x, int y, const char *str) {
   auto fbBuff = (uint8_t*)state.fb->buffer;
   uint64_t *buffStart = (uint64_t*)&fbBuff[y * fbStride + x*2];
-  uint64_t col = (uint64_t)currColor;
 
   while(*str)
   {
@@ -40,21 +63,13 @@ int Text::print(int x, int y, const char *str) {
     uint64_t *buff = buffStart;
     ++x;
 
-    uint64_t val;
     if(charCode != ignoreChar)
     {
       for(int y=0; y<8; ++y) {
-        for(int x=0; x<2; ++x) {
-          val  = (charData & 0b0001) ? (col << 48) : 0;
-          val |= (charData & 0b0010) ? (col << 32) : 0;
-          val |= (charData & 0b0100) ? (col << 16) : 0;
-          val |= (charData & 0b1000) ? (col <<  0) : 0;
-
-          *buff = val;
-          charData >>= 4;
-          ++buff;
-        }
-        buff += (fbStride/8 - 2);
+        buff[0] = colorLUT[charData & 0xF];
+        buff[1] = colorLUT[(charData >> 4) & 0xF];
+        charData >>= 8;
+        buff += fbStride/8;
       }
       // draw extra black line below
       buff[0] = 0;
@@ -78,67 +93,525 @@ int Text::printf(int x, int y, const char *fmt, ...) {
   return print(x, y, buffer);
 }
 
+namespace {
+  // writes 'len' characters right-aligned into [buff, end), clamped, returns the new end
+  char* appendPadded(char* buff, const char* end, const Text::Fmt::Spec &spec, const char* str, uint32_t len, char pad) {
+    uint32_t padding = spec.width > len ? (spec.width - len) : 0;
+    if(!spec.leftAlign) {
+      for(; padding && buff != end; --padding)*(buff++) = pad;
+    }
+    for(uint32_t i=0; i<len && buff != end; ++i)*(buff++) = str[i];
+    for(; padding && buff != end; --padding)*(buff++) = ' ';
+    return buff;
+  }
+
+  // writes 'value' backwards in front of 'ptr', returns the first digit
+  char* toDigits(char* ptr, uint64_t value, uint32_t base, bool upper) {
+    const char* chars = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    do {
+      *(--ptr) = chars[value % base];
+      value /= base;
+    } while(value);
+    return ptr;
+  }
+
+  // 'str' needs one free character in front of it for the sign
+  char* appendNumber(char* buff, const char* end, const Text::Fmt::Spec &spec, char* str, const char* strEnd, bool isNeg) {
+    // sign goes in front of zero-padding
+    bool zeroPad = spec.zeroPad && !spec.leftAlign;
+    auto padSpec = spec;
+    if(isNeg) {
+      if(zeroPad) {
+        if(buff != end)*(buff++) = '-';
+        if(padSpec.width)--padSpec.width;
+      } else {
+        *(--str) = '-';
+      }
+    }
+    return appendPadded(buff, end, padSpec, str, strEnd - str, zeroPad ? '0' : ' ');
+  }
+}
+
+char* Text::Fmt::appendLiteral(char* buff, const char* end, const char* str, uint32_t len)
+{
+  for(uint32_t i=0; i<len && buff != end; ++i)*(buff++) = str[i];
+  return buff;
+}
+
+char* Text::Fmt::appendInt(char* buff, const char* end, const Spec &spec, int64_t value)
+{
+  char digits[24];
+  char* str = toDigits(digits + sizeof(digits), value < 0 ? -(uint64_t)value : value, 10, false);
+  return appendNumber(buff, end, spec, str, digits + sizeof(digits), value < 0);
+}
+
+char* Text::Fmt::appendUInt(char* buff, const char* end, const Spec &spec, uint64_t value)
+{
+  char digits[24];
+  uint32_t base = spec.type == Type::INT ? 10 : 16;
+  char* str = toDigits(digits + sizeof(digits), value, base, spec.type == Type::HEX_UPPER);
+  return appendNumber(buff, end, spec, str, digits + sizeof(digits), false);
+}
+
+char* Text::Fmt::appendFloat(char* buff, const char* end, const Spec &spec, float value)
+{
+  constexpr uint32_t POW10[]{1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+  constexpr float MAX_VALUE = 1e15f;
+  constexpr double MAX_SCALED = 1.8e19; // below 2^64, so the fixed-point value always fits into 'uint64_t'
+
+  bool isNeg = value < 0;
+  if(isNeg)value = -value;
+  if(!(value < MAX_VALUE))value = MAX_VALUE; // also catches NaN
+
+  // fixed-point with 'precision' fractional digits, ties round to even like printf
+  double scaled = (double)value * POW10[spec.precision];
+  if(scaled > MAX_SCALED)scaled = MAX_SCALED; // large values with a high precision
+  uint64_t fixed = (uint64_t)scaled;
+  double rest = scaled - fixed;
+  if(rest > 0.5 || (rest == 0.5 && (fixed & 1)))++fixed;
+
+  uint64_t intPart = fixed / POW10[spec.precision];
+  uint32_t fracPart = fixed % POW10[spec.precision];
+
+  char digits[40];
+  char* str = digits + sizeof(digits);
+  for(uint32_t i=0; i<spec.precision; ++i) {
+    *(--str) = '0' + (fracPart % 10);
+    fracPart /= 10;
+  }
+  if(spec.precision)*(--str) = '.';
+  str = toDigits(str, intPart, 10, false);
+  return appendNumber(buff, end, spec, str, digits + sizeof(digits), isNeg);
+}
+
+char* Text::Fmt::appendStr(char* buff, const char* end, const Spec &spec, const char* str)
+{
+  return appendPadded(buff, end, spec, str, strlen(str), ' ');
+}
+
+namespace {
+  constexpr int LARGE_SIZE = 64;
+  // visible glyphs are drawn in batches of this size ('posCB' can place any number on screen)
+  constexpr uint32_t LARGE_MAX_GLYPHS = 16;
+  // runs of a scanline are flushed whenever the buffer is full, so this only limits the merging
+  constexpr uint32_t LARGE_MAX_RUNS = 64;
+
+  struct LargeGlyph {
+    const uint8_t *data; // RLE of the next row to decode
+    int x, y;
+  };
+
+  // solid pixels in [start, end) of a scanline
+  struct LargeRun {
+    int16_t start, end;
+  };
+
+  const uint8_t* skipLargeRow(const uint8_t *data) {
+    int totalSize = 0;
+    while(totalSize != LARGE_SIZE)totalSize += *(data++);
+    return data;
+  }
+
+  void writeLargeRun(uint16_t *line, int start, int end, uint64_t color) {
+    uint16_t *buff = line + start;
+    int size = end - start;
+    if(size < (16/2)) {
+      for(int s=0; s<size; ++s)buff[s] = color;
+    } else if(color == 0) {
+      MiMem::zeroUnaligned((volatile char*)buff, size * 2);
+    } else {
+      MiMem::write(buff, color, size * 2);
+    }
+  }
+
+  // merges overlapping/touching runs of all glyphs on a scanline, each result is clipped and written once
+  void flushLargeRuns(LargeRun *runs, uint32_t count, uint16_t *line, int width, uint64_t color) {
+    if(count == 0)return;
+
+    for(uint32_t i=1; i<count; ++i) {
+      LargeRun run = runs[i];
+      uint32_t j = i;
+      for(; j > 0 && runs[j-1].start > run.start; --j)runs[j] = runs[j-1];
+      runs[j] = run;
+    }
+
+    LargeRun curr = runs[0];
+    for(uint32_t i=1; i<=count; ++i) {
+      if(i < count && runs[i].start <= curr.end) {
+        if(runs[i].end > curr.end)curr.end = runs[i].end;
+        continue;
+      }
+      int start = curr.start < 0 ? 0 : curr.start;
+      int end = curr.end > width ? width : curr.end;
+      if(end > start)writeLargeRun(line, start, end, color);
+      if(i < count)curr = runs[i];
+    }
+  }
+
+  // draws a batch of glyphs, the runs of each scanline are merged across all of them
+  void drawLargeGlyphs(LargeGlyph *glyphs, uint32_t glyphCount, int minY, int maxY, uint64_t color)
+  {
+    int width = state.fb->width;
+    int height = state.fb->height;
+    int lineStart = minY < 0 ? 0 : minY;
+    int lineEnd = (maxY + LARGE_SIZE) > height ? height : (maxY + LARGE_SIZE);
+
+    // rows above the screen are only decoded
+    for(uint32_t g=0; g<glyphCount; ++g) {
+      for(int l=glyphs[g].y; l<lineStart; ++l)glyphs[g].data = skipLargeRow(glyphs[g].data);
+    }
+
+    std::array<LargeRun, LARGE_MAX_RUNS> runs;
+    auto fbBuff = (uint8_t*)state.fb->buffer;
+
+    for(int line=lineStart; line<lineEnd; ++line)
+    {
+      auto lineBuff = (uint16_t*)&fbBuff[line * fbStride];
+      uint32_t runCount = 0;
+
+      for(uint32_t g=0; g<glyphCount; ++g)
+      {
+        auto &glyph = glyphs[g];
+        if(line < glyph.y || line >= glyph.y + LARGE_SIZE)continue;
+
+        // each row alternates between empty and solid runs, starting empty
+        int posX = glyph.x;
+        int totalSize = 0;
+        bool isSolid = false;
+        while(totalSize != LARGE_SIZE) {
+          uint8_t size = *(glyph.data++);
+          if(isSolid && size) {
+            if(runCount == runs.size()) {
+              flushLargeRuns(runs.data(), runCount, lineBuff, width, color);
+              runCount = 0;
+            }
+            runs[runCount++] = {(int16_t)posX, (int16_t)(posX + size)};
+          }
+          posX += size;
+          totalSize += size;
+          isSolid = !isSolid;
+        }
+      }
+
+      flushLargeRuns(runs.data(), runCount, lineBuff, width, color);
+    }
+  }
+}
+
 int Text::printLarge(int x, int y, const char *str, const TextFX &conf) {
   constexpr int CHAR_INCR = 40;
   int charIdx = 0;
 
-  auto fbBuff = (uint8_t*)state.fb->buffer;
+  int width = state.fb->width;
+  int height = state.fb->height;
+
+  std::array<LargeGlyph, LARGE_MAX_GLYPHS> glyphs;
+  uint32_t glyphCount = 0;
+  int minY = height;
+  int maxY = -LARGE_SIZE;
 
   while(*str)
   {
     uint8_t charCode = (uint8_t)*str - ' ';
-    uint32_t dataStart = FONT_64_IDX[charCode];
-
     if(conf.posCB) {
       conf.posCB(x, y, charIdx++);
     }
 
-    if(charCode == 0 || x < -64 || x > 320) {
-      ++str;
-      x += CHAR_INCR;
+    bool isVisible = x > -LARGE_SIZE && x < width && y > -LARGE_SIZE && y < height;
+    if(charCode != 0 && isVisible) {
+      if(glyphCount == glyphs.size()) {
+        drawLargeGlyphs(glyphs.data(), glyphCount, minY, maxY, conf.color);
+        glyphCount = 0;
+        minY = height;
+        maxY = -LARGE_SIZE;
+      }
+      glyphs[glyphCount++] = {&FONT_64_DATA[FONT_64_IDX[charCode]], x, y};
+      if(y < minY)minY = y;
+      if(y > maxY)maxY = y;
+    }
+
+    ++str;
+    x += CHAR_INCR;
+  }
+
+  drawLargeGlyphs(glyphs.data(), glyphCount, minY, maxY, conf.color);
+  return x;
+}
+
+namespace {
+  struct LayerDrawn {
+    char text[Text::Layer::MAX_LENGTH + 1]{};
+    uint16_t version{};
+    uint16_t color{};
+    int16_t x{}, y{};
+    uint8_t len{};
+  };
+
+  struct LayerEntry {
+    char text[Text::Layer::MAX_LENGTH + 1]{};
+    int16_t x{}, y{};
+    uint16_t color{};
+    uint16_t version{}; // 0 = free slot
+    bool removed{};
+    LayerDrawn drawn[Text::Layer::MAX_BUFFERS]{};
+  };
+
+  constinit std::array<LayerEntry, Text::Layer::MAX_ENTRIES> layerEntries{};
+  constinit std::array<void*, Text::Layer::MAX_BUFFERS> layerBuffers{};
+  constinit uint32_t layerNextBuffer = 0;
+
+  void bumpVersion(LayerEntry &entry) {
+    if(++entry.version == 0)entry.version = 1;
+  }
+
+  // clears glyph cells (incl. the black line below) of a previously drawn string
+  void clearCells(int x, int y, int len) {
+    auto fbBuff = (uint8_t*)state.fb->buffer;
+    uint64_t *buff = (uint64_t*)&fbBuff[y * fbStride + x*2];
+    for(int l=0; l<9; ++l) {
+      for(int i=0; i<len*2; ++i)buff[i] = 0;
+      buff += fbStride/8;
+    }
+  }
+
+  uint32_t layerBufferIndex(void* fbBuffer) {
+    for(uint32_t b=0; b<layerBuffers.size(); ++b) {
+      if(layerBuffers[b] == fbBuffer)return b;
+    }
+    // unknown buffer, its content is unknown too
+    uint32_t b = layerNextBuffer;
+    layerNextBuffer = (layerNextBuffer + 1) % layerBuffers.size();
+    layerBuffers[b] = fbBuffer;
+    for(auto &entry : layerEntries)entry.drawn[b] = {};
+    return b;
+  }
+}
+
+Text::Layer::Handle Text::Layer::create()
+{
+  for(uint32_t i=0; i<layerEntries.size(); ++i) {
+    auto &entry = layerEntries[i];
+    if(entry.version)continue;
+    entry = {};
+    entry.version = 1;
+    return i;
+  }
+  assertf(false, "Text::Layer: out of entries");
+  return 0;
+}
+
+void Text::Layer::remove(Handle handle)
+{
+  auto &entry = layerEntries[handle];
+  entry.removed = true;
+  entry.text[0] = '\0';
+  bumpVersion(entry);
+}
+
+void Text::Layer::removeAll()
+{
+  layerEntries = {};
+}
+
+void Text::Layer::print(Handle handle, int x, int y, const char *str)
+{
+  auto &entry = layerEntries[handle];
+  if(entry.x == x && entry.y == y && entry.color == currColor
+    && strncmp(entry.text, str, MAX_LENGTH) == 0)return;
+
+  uint32_t len = strnlen(str, MAX_LENGTH);
+  memcpy(entry.text, str, len);
+  entry.text[len] = '\0';
+  entry.x = x;
+  entry.y = y;
+  entry.color = currColor;
+  bumpVersion(entry);
+}
+
+void Text::Layer::printf(Handle handle, int x, int y, const char *fmt, ...)
+{
+  char buffer[MAX_LENGTH + 1];
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(buffer, sizeof(buffer), fmt, args);
+  va_end(args);
+  print(handle, x, y, buffer);
+}
+
+void Text::Layer::invalidate()
+{
+  uint32_t b = layerBufferIndex(state.fb->buffer);
+  for(auto &entry : layerEntries)entry.drawn[b] = {};
+}
+
+void Text::Layer::invalidateAll()
+{
+  for(auto &entry : layerEntries) {
+    for(auto &drawn : entry.drawn)drawn = {};
+  }
+}
+
+uint32_t Text::Layer::draw(int y0, int y1)
+{
+  uint32_t b = layerBufferIndex(state.fb->buffer);
+  uint32_t redrawCount = 0;
+
+  // spaces must overwrite whatever was drawn before
+  uint8_t oldIgnoreChar = ignoreChar;
+  uint16_t oldColor = currColor;
+  ignoreChar = 0xFF;
+
+  for(auto &entry : layerEntries)
+  {
+    if(!entry.version)continue;
+    auto &drawn = entry.drawn[b];
+
+    int firstRow = (entry.removed || (drawn.len && drawn.y < entry.y)) ? drawn.y : entry.y;
+    if(firstRow < 0)firstRow = 0;
+    if(firstRow < y0 || firstRow >= y1)continue;
+
+    if(entry.removed) {
+      if(drawn.len)clearCells(drawn.x, drawn.y, drawn.len);
+      drawn = {};
+      bool isDrawn = false;
+      for(auto &d : entry.drawn)isDrawn |= d.len != 0;
+      if(!isDrawn)entry = {};
       continue;
     }
 
-    uint16_t *buffStart = (uint16_t*)&fbBuff[y * fbStride];
-    uint16_t *buff = (uint16_t*)&fbBuff[y * fbStride + x*2];
+    if(drawn.version == entry.version)continue;
 
-    uint8_t *sizeData = &FONT_64_DATA[dataStart];
-    int totalSize = 0;
-    bool isSolid = false;
+    if(entry.color != currColor) {
+      currColor = entry.color;
+      colorLUT = buildColorLUT(currColor);
+    }
 
-    while(totalSize != (64*64)) {
-      uint8_t size = *sizeData;
-      totalSize += size;
-      ++sizeData;
+    int len = strlen(entry.text);
+    if(drawn.len && (drawn.x != entry.x || drawn.y != entry.y)) {
+      clearCells(drawn.x, drawn.y, drawn.len);
+      drawn.len = 0;
+    }
 
-      if(isSolid) {
-        if(buff < buffStart || size < (16/2)) {
-          for(int s=0; s<size; ++s) {
-            buff[s] = conf.color;
-          }
-        } else {
-          if(conf.color == 0) {
-            MiMem::zeroUnaligned((volatile char*)buff, size * 2);
-          } else {
-            MiMem::write(buff, conf.color, size * 2);
-          }
-        }
-      }
+    // only touch glyphs that differ from what this buffer shows
+    bool sameColor = drawn.color == entry.color;
+    char glyph[2]{};
+    for(int i=0; i<len; ++i) {
+      if(sameColor && i < drawn.len && drawn.text[i] == entry.text[i])continue;
+      glyph[0] = entry.text[i];
+      Text::print(entry.x + i*8, entry.y, glyph);
+    }
+    if(drawn.len > len) {
+      clearCells(entry.x + len*8, entry.y, drawn.len - len);
+    }
 
-      buff += size;
-      isSolid = !isSolid;
+    memcpy(drawn.text, entry.text, sizeof(drawn.text));
+    drawn.version = entry.version;
+    drawn.color = entry.color;
+    drawn.x = entry.x;
+    drawn.y = entry.y;
+    drawn.len = len;
+    ++redrawCount;
+  }
 
-      if((totalSize % 64) == 0) {
-        buff += (fbStride/2 - 64);
-        buffStart += (fbStride/2);
-        isSolid = false;
+  if(oldColor != currColor) {
+    currColor = oldColor;
+    colorLUT = buildColorLUT(currColor);
+  }
+  ignoreChar = oldIgnoreChar;
+  return redrawCount;
+}
+
+namespace {
+  // I4 font atlas, 2 glyphs per row (= one TMEM word), each cell has an empty line below
+  constexpr uint32_t ATLAS_GLYPHS = 96;
+  constexpr uint32_t ATLAS_STRIDE = 8;
+  constexpr uint32_t ATLAS_CELL_HEIGHT = 9;
+  constexpr uint32_t ATLAS_HEIGHT = (ATLAS_GLYPHS / 2) * ATLAS_CELL_HEIGHT;
+  static_assert(ATLAS_STRIDE * ATLAS_HEIGHT <= 4096, "Font must fit into TMEM");
+
+  constinit uint8_t *fontAtlas{};
+  constinit uint32_t batchColor{};
+
+  uint8_t* buildFontAtlas() {
+    auto atlas = (uint8_t*)malloc_uncached(ATLAS_STRIDE * ATLAS_HEIGHT);
+    memset(atlas, 0, ATLAS_STRIDE * ATLAS_HEIGHT);
+
+    for(uint32_t c=0; c<std::size(FONT_8x8_DATA); ++c) {
+      uint64_t charData = FONT_8x8_DATA[c];
+      uint8_t *row = &atlas[(c / 2) * ATLAS_CELL_HEIGHT * ATLAS_STRIDE + (c % 2) * 4];
+      for(int y=0; y<8; ++y) {
+        // left pixel in the upper nibble
+        for(int x=0; x<4; ++x) {
+          row[x] = ((charData & 1) ? 0xF0 : 0) | ((charData & 2) ? 0x0F : 0);
+          charData >>= 2;
+        }
+        row += ATLAS_STRIDE;
       }
     }
+    return atlas;
+  }
+}
 
-    ++str;
-    x += CHAR_INCR;
+void Text::Batch::begin(RDP::DPL &dpl)
+{
+  if(!fontAtlas)fontAtlas = buildFontAtlas();
+  batchColor = currColorRGBA;
+
+  // (PRIM - ENV) * TEX0 + ENV, with a black ENV this fills the whole cell like the CPU version
+  // TMEM may be used by other demos, so the font is loaded again each batch (RDP-side only)
+  dpl.add(RDP::syncPipe())
+    .add(RDP::setColorImage(state.fb->buffer, RDP::Format::RGBA, RDP::BBP::_16, state.fb->stride/2))
+    .add(RDP::setScissor(0, 0, state.fb->width-1, state.fb->height-1))
+    .add(RDP::setOtherModes(RDP::OtherMode()
+      .cycleType(RDP::CYCLE::ONE)
+      .texFilterRGB()
+      .ditherRGBA(RDP::DitherRGB::DISABLED)
+      .ditherAlpha(RDP::DitherAlpha::DISABLED)
+    ))
+    .add(RDP::setCC1Cycle({
+      RDP::CC::C_A::PRIM, RDP::CC::C_B::ENV, RDP::CC::C_C::TEX0, RDP::CC::C_D::ENV,
+      RDP::CC::A_ABD::ZERO, RDP::CC::A_ABD::ZERO, RDP::CC::A_C::ZERO, RDP::CC::A_ABD::ONE
+    }))
+    .add(RDP::setPrimColor(batchColor))
+    .add(RDP::setEnvColor(0x0000'00FF))
+    .add(RDP::setSyncLoad())
+    .add(RDP::setTextureImage(fontAtlas, RDP::Format::I, RDP::BBP::_8, ATLAS_STRIDE))
+    .add(RDP::setTile(7, RDP::Format::I, RDP::BBP::_8, 1, 0))
+    .add(RDP::loadTile(7, 0, 0, ATLAS_STRIDE-1, ATLAS_HEIGHT-1))
+    .add(RDP::setSyncTile())
+    .add(RDP::setTile(0, RDP::Format::I, RDP::BBP::_4, 1, 0))
+    .add(RDP::setTileSize(0, 0, 0, ATLAS_STRIDE*2 - 1, ATLAS_HEIGHT-1));
+}
+
+int Text::Batch::print(RDP::DPL &dpl, int x, int y, const char *str)
+{
+  if(currColorRGBA != batchColor) {
+    batchColor = currColorRGBA;
+    dpl.add(RDP::syncPipe()).add(RDP::setPrimColor(batchColor));
   }
 
+  int posX = x;
+  while(*str)
+  {
+    uint8_t charCode = (uint8_t)*str - ' ';
+    if(charCode != ignoreChar) {
+      dpl.add(RDP::textureRect(0, posX, y, posX + 8, y + ATLAS_CELL_HEIGHT,
+        (charCode % 2) * 8, (charCode / 2) * ATLAS_CELL_HEIGHT
+      ));
+    }
+    posX += 8;
+    ++x;
+    ++str;
+  }
   return x;
 }
 
+int Text::Batch::printf(RDP::DPL &dpl, int x, int y, const char *fmt, ...)
+{
+  char buffer[FMT_BUFF_SIZE];
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(buffer, FMT_BUFF_SIZE, fmt, args);
+  va_end(args);
+  return print(dpl, x, y, buffer);
+}
@@ -3,6 +3,9 @@
 * @license MIT
 */
 #pragma once
+#include "textFormat.h"
+
+namespace RDP { struct DPL; }
 
 namespace Text
 {
@@ -11,6 +14,14 @@ namespace Text
   int print(int x, int y, const char* str);
   int printf(int x, int y, const char *fmt, ...);
 
+  // same as 'printf', but with the format parsed at compile time (see textFormat.h)
+  template<typename... Args>
+  int printFmt(int x, int y, Fmt::String<std::type_identity_t<Args>...> fmt, Args... args) {
+    char buff[Fmt::BUFF_SIZE]{};
+    format(buff, sizeof(buff), fmt, args...);
+    return print(x, y, buff);
+  }
+
   typedef void (*TextFXCb)(int &x, int &y, int idx);
 
   struct TextFX {
@@ -20,3 +31,63 @@ namespace Text
 
   int printLarge(int x, int y, const char* str, const TextFX &fx);
 }
+
+/**
+ * Retained text, strings are registered once by handle and only redrawn into
+ * a framebuffer if their content/color/position changed since it was last drawn there.
+ * Only for framebuffers that are not cleared every frame, see 'State::clearsScreen'.
+ */
+namespace Text::Layer
+{
+  using Handle = uint8_t;
+
+  constexpr uint32_t MAX_ENTRIES = 32;
+  constexpr uint32_t MAX_LENGTH = 40;
+  constexpr uint32_t MAX_BUFFERS = 3;
+
+  Handle create();
+  // erases the string from each buffer on its next draw, then frees the handle
+  void remove(Handle handle);
+  // forgets all strings without erasing them (e.g. after all buffers got cleared)
+  void removeAll();
+
+  // uses the current color of 'Text::setColor', does nothing if unchanged
+  void print(Handle handle, int x, int y, const char* str);
+  void printf(Handle handle, int x, int y, const char *fmt, ...);
+
+  template<typename... Args>
+  void printFmt(Handle handle, int x, int y, Fmt::String<std::type_identity_t<Args>...> fmt, Args... args) {
+    char buff[MAX_LENGTH + 1];
+    format(buff, sizeof(buff), fmt, args...);
+    print(handle, x, y, buff);
+  }
+
+  // marks the current / all framebuffers as cleared
+  void invalidate();
+  void invalidateAll();
+
+  /**
+   * Draws all changes into 'state.fb', returns the number of redrawn strings.
+   * With a row range, only strings whose first touched row (new or old position) is in [y0, y1),
+   * e.g. per beam-racing band, so each string is done before the VI reaches it.
+   */
+  uint32_t draw(int y0 = 0, int y1 = INT32_MAX);
+}
+
+/**
+ * RDP backend, glyphs are textured rectangles sampling the font from TMEM (I4).
+ * Output matches 'Text::print' (incl. the black line below each glyph), the color is taken from 'Text::setColor'.
+ * Commands are only recorded, the caller submits the DPL (e.g. together with other drawing).
+ */
+namespace Text::Batch
+{
+  // DPL commands needed by 'begin', per glyph and per color change
+  constexpr uint32_t SETUP_CMDS = 14;
+  constexpr uint32_t GLYPH_CMDS = 2;
+  constexpr uint32_t COLOR_CMDS = 2;
+
+  // targets 'state.fb' and loads the font into TMEM
+  void begin(RDP::DPL &dpl);
+  int print(RDP::DPL &dpl, int x, int y, const char* str);
+  int printf(RDP::DPL &dpl, int x, int y, const char *fmt, ...);
+}
@@ -0,0 +1,164 @@
+/**
+* @copyright 2025 - Max Bebök
+* @license MIT
+*/
+#pragma once
+#include <libdragon.h>
+#include <array>
+#include <type_traits>
+#include <utility>
+
+/**
+ * printf-style formatting with the format string parsed at compile time.
+ * Supports '%d/%i/%u', '%x/%X', '%f' (fixed-point), '%s', '%c' and '%%',
+ * with the flags '-' and '0', a width and a precision (e.g. "%-8s", "%08X", "%6.2f").
+ * Mismatching argument counts or types are compile errors, no varargs are involved.
+ */
+namespace Text::Fmt
+{
+  constexpr uint32_t MAX_LITERAL = 64;
+  constexpr uint32_t MAX_WIDTH = 32;
+  constexpr uint32_t BUFF_SIZE = 128;
+
+  enum class Type : uint8_t { INT, HEX, HEX_UPPER, FLOAT, STR, CHAR };
+
+  struct Spec {
+    uint8_t litStart{}; // literal text in front of the argument
+    uint8_t litLen{};
+    Type type{};
+    uint8_t width{};
+    uint8_t precision{};
+    bool zeroPad{};
+    bool leftAlign{};
+  };
+
+  template<typename T>
+  consteval bool isArgValid(Type type) {
+    using U = std::remove_cvref_t<T>;
+    switch(type) {
+      case Type::FLOAT: return std::is_floating_point_v<U>;
+      case Type::STR  : return std::is_convertible_v<U, const char*>;
+      default         : return std::is_integral_v<U>;
+    }
+  }
+
+  template<typename... Args>
+  struct String
+  {
+    std::array<Spec, sizeof...(Args)> specs{};
+    char literal[MAX_LITERAL]{}; // all literal text with '%%' resolved
+    uint8_t tailStart{};
+    uint8_t tailLen{};
+
+    // errors throw, which turns them into compile errors in a constant evaluation
+    consteval String(const char* str)
+    {
+      uint32_t litPos = 0;
+      uint32_t litStart = 0;
+      uint32_t argIdx = 0;
+
+      auto pushLit = [&](char c) {
+        if(litPos >= MAX_LITERAL)throw "Text::Fmt: literal text too long";
+        literal[litPos++] = c;
+      };
+
+      for(; *str; ++str)
+      {
+        if(*str != '%') { pushLit(*str); continue; }
+        ++str;
+        if(*str == '%') { pushLit('%'); continue; }
+        if(argIdx >= sizeof...(Args))throw "Text::Fmt: more placeholders than arguments";
+
+        Spec spec{};
+        spec.litStart = litStart;
+        spec.litLen = litPos - litStart;
+        spec.precision = 6;
+
+        for(;; ++str) {
+          if(*str == '-')spec.leftAlign = true;
+          else if(*str == '0')spec.zeroPad = true;
+          else break;
+        }
+        for(; *str >= '0' && *str <= '9'; ++str)spec.width = spec.width * 10 + (*str - '0');
+        if(*str == '.') {
+          spec.precision = 0;
+          for(++str; *str >= '0' && *str <= '9'; ++str)spec.precision = spec.precision * 10 + (*str - '0');
+        }
+        while(*str == 'l' || *str == 'h')++str;
+        if(spec.width > MAX_WIDTH || spec.precision > 9)throw "Text::Fmt: width/precision too large";
+
+        switch(*str) {
+          case 'd': case 'i': case 'u': spec.type = Type::INT; break;
+          case 'x': spec.type = Type::HEX; break;
+          case 'X': spec.type = Type::HEX_UPPER; break;
+          case 'f': spec.type = Type::FLOAT; break;
+          case 's': spec.type = Type::STR; break;
+          case 'c': spec.type = Type::CHAR; break;
+          default: throw "Text::Fmt: unsupported placeholder";
+        }
+
+        bool valid = false;
+        uint32_t i = 0;
+        ((valid |= (i++ == argIdx) && isArgValid<Args>(spec.type)), ...);
+        if(!valid)throw "Text::Fmt: argument type does not match the placeholder";
+
+        specs[argIdx++] = spec;
+        litStart = litPos;
+      }
+
+      if(argIdx != sizeof...(Args))throw "Text::Fmt: more arguments than placeholders";
+      tailStart = litStart;
+      tailLen = litPos - litStart;
+    }
+  };
+
+  char* appendLiteral(char* buff, const char* end, const char* str, uint32_t len);
+  char* appendInt(char* buff, const char* end, const Spec &spec, int64_t value);
+  char* appendUInt(char* buff, const char* end, const Spec &spec, uint64_t value);
+  char* appendFloat(char* buff, const char* end, const Spec &spec, float value);
+  char* appendStr(char* buff, const char* end, const Spec &spec, const char* str);
+
+  template<typename T>
+  char* appendArg(char* buff, const char* end, const Spec &spec, T value)
+  {
+    if constexpr(std::is_floating_point_v<T>) {
+      return appendFloat(buff, end, spec, value);
+    } else if constexpr(std::is_integral_v<T>) {
+      if(spec.type == Type::CHAR) {
+        char str[2]{(char)value, '\0'};
+        return appendStr(buff, end, spec, str);
+      }
+      if constexpr(std::is_signed_v<T>) {
+        if(spec.type == Type::INT)return appendInt(buff, end, spec, value);
+        return appendUInt(buff, end, spec, (std::make_unsigned_t<T>)value);
+      } else {
+        return appendUInt(buff, end, spec, value);
+      }
+    } else {
+      return appendStr(buff, end, spec, value);
+    }
+  }
+}
+
+namespace Text
+{
+  /**
+   * Formats into 'buff' (zero-terminated), returns the length.
+   * Output is cut off at 'size'-1 characters.
+   */
+  template<typename... Args>
+  int format(char* buff, uint32_t size, Fmt::String<std::type_identity_t<Args>...> fmt, Args... args)
+  {
+    char* ptr = buff;
+    const char* end = buff + size - 1;
+    [&]<size_t... I>(std::index_sequence<I...>) {
+      ((
+        ptr = Fmt::appendLiteral(ptr, end, fmt.literal + fmt.specs[I].litStart, fmt.specs[I].litLen),
+        ptr = Fmt::appendArg(ptr, end, fmt.specs[I], args)
+      ), ...);
+    }(std::index_sequence_for<Args...>{});
+    ptr = Fmt::appendLiteral(ptr, end, fmt.literal + fmt.tailStart, fmt.tailLen);
+    *ptr = '\0';
+    return ptr - buff;
+  }
+}
@@ -0,0 +1,339 @@
+/**
+* @copyright 2025 - Max Bebök
+* @license MIT
+*/
+#include "viTimeline.h"
+
+namespace
+{
+  constexpr int NO_TABLE = -1;
+  constexpr uint32_t LINES_PER_STEP = 2; // VI_V_CURRENT counts half-lines
+  constexpr uint32_t V_TOTAL = 525; // half-lines per NTSC frame, VI_V_CURRENT never reaches it
+  // the vblank interrupt is taken while the beam is still in here, and at most once per frame
+  constexpr uint32_t VBLANK_WINDOW_END = VI_V_CURRENT_VBLANK + 16;
+  constexpr uint64_t VBLANK_MIN_TICKS = TICKS_FROM_MS(8);
+
+  struct Write {
+    volatile uint32_t *reg;
+    uint32_t value;
+    uint32_t line;
+  };
+
+  struct Table {
+    Write writes[VITimeline::MAX_WRITES];
+    uint32_t count;
+  };
+
+  // one is filled by the demo, one waits for the vblank and one is read by the interrupt
+  constinit Table tables[3]{};
+  constinit int idxBuild{0};
+  constinit int idxPending{NO_TABLE};
+  constinit int idxActive{NO_TABLE};
+  constinit bool stopRequested{};
+  constinit bool liveRequested{};
+  constinit bool liveActive{};
+
+  constinit uint32_t nextWrite{};
+  constinit uint32_t armedLine{VI_V_CURRENT_VBLANK};
+  using Callback = void(*)();
+  constinit Callback vblankCallback{};
+  constinit uint32_t pendingOrigin{};
+  constinit volatile uint32_t vblanks{};
+
+  constinit VITimeline::Stats stats{};
+  constinit VITimeline::Stats statsFrame{};
+  constinit uint64_t lastLineTicks{};
+  constinit uint64_t lastVBlankTicks{};
+  constinit uint32_t lastLine{};
+
+  // opt-in recorder, line records are double-buffered per frame
+  constinit bool recording{};
+  constinit VITimeline::Histogram histogram{};
+  constinit VITimeline::LineRecord lineRecords[2][VITimeline::MAX_LINE_RECORDS]{};
+  constinit uint32_t lineRecordCount[2]{};
+  constinit uint32_t lineRecordIdx{};
+
+  struct Probe {
+    volatile uint32_t *reg;
+    uint32_t line;
+    uint32_t value;
+    uint64_t ticks;
+    bool armed;
+  };
+  constinit Probe probe{};
+
+  void record(uint32_t line, uint32_t lineAfter, uint64_t ticksEntry, uint64_t ticksWrite)
+  {
+    uint32_t latency = ticksWrite - ticksEntry;
+    uint32_t bucket = latency / VITimeline::HIST_BUCKET_TICKS;
+    if(bucket >= VITimeline::HIST_BUCKETS)bucket = VITimeline::HIST_BUCKETS-1;
+
+    ++histogram.buckets[bucket];
+    ++histogram.samples;
+    if(latency > histogram.maxTicks)histogram.maxTicks = latency;
+    if(lineAfter > line)histogram.missedLines += (lineAfter - line) / LINES_PER_STEP;
+
+    uint32_t &count = lineRecordCount[lineRecordIdx];
+    if(count < VITimeline::MAX_LINE_RECORDS) {
+      lineRecords[lineRecordIdx][count++] = {
+        .line = (uint16_t)line, .lineAfter = (uint16_t)lineAfter,
+        .ticksEntry = (uint32_t)ticksEntry, .ticksWrite = (uint32_t)ticksWrite
+      };
+    }
+  }
+
+  int freeTable() {
+    for(int i=0; i<3; ++i) {
+      if(i != idxPending && i != idxActive)return i;
+    }
+    return 0;
+  }
+
+  void applyDue(uint64_t ticksEntry)
+  {
+    auto &table = tables[idxActive];
+    uint32_t currLine = *VI_V_CURRENT;
+    uint32_t firstLine = table.writes[nextWrite].line;
+
+    while(nextWrite < table.count && table.writes[nextWrite].line <= currLine) {
+      auto &write = table.writes[nextWrite++];
+      *write.reg = write.value;
+      if(write.line < (currLine & ~(LINES_PER_STEP-1)))++statsFrame.lateWrites;
+
+      if(probe.armed && write.line == probe.line && write.reg == probe.reg && write.value != probe.value) {
+        probe.ticks = get_ticks();
+        probe.armed = false;
+      }
+    }
+
+    uint64_t ticks = get_ticks();
+    if(recording)record(firstLine, *VI_V_CURRENT & ~(LINES_PER_STEP-1), ticksEntry, ticks);
+    uint32_t handlerTicks = ticks - ticksEntry;
+    if(handlerTicks > statsFrame.handlerTicks)statsFrame.handlerTicks = handlerTicks;
+
+    // normalized to a single line, so sparse tables still compare
+    if(lastLineTicks && firstLine > lastLine) {
+      uint32_t lineTicks = (ticksEntry - lastLineTicks) * LINES_PER_STEP / (firstLine - lastLine);
+      if(!statsFrame.lineTicksMin || lineTicks < statsFrame.lineTicksMin)statsFrame.lineTicksMin = lineTicks;
+      if(lineTicks > statsFrame.lineTicksMax)statsFrame.lineTicksMax = lineTicks;
+    }
+    lastLineTicks = ticksEntry;
+    lastLine = firstLine;
+  }
+
+  // sets the interrupt to the next write, lines that were already passed are applied right away
+  void armNext()
+  {
+    while(idxActive != NO_TABLE && nextWrite < tables[idxActive].count) {
+      armedLine = tables[idxActive].writes[nextWrite].line;
+      *VI_V_INTR = armedLine;
+      if(*VI_V_CURRENT < armedLine)return;
+      applyDue(get_ticks());
+    }
+    armedLine = VI_V_CURRENT_VBLANK;
+    *VI_V_INTR = armedLine;
+  }
+
+  void onInterrupt()
+  {
+    uint64_t ticks = get_ticks();
+    uint32_t currLine = *VI_V_CURRENT & ~(LINES_PER_STEP-1);
+    if(armedLine != VI_V_CURRENT_VBLANK && currLine >= armedLine) {
+      ++statsFrame.interrupts;
+      applyDue(ticks);
+      armNext();
+      return;
+    }
+
+    // a line already applied by 'armNext' can still raise its interrupt, only a new frame is the vblank
+    bool isVBlank = currLine < VBLANK_WINDOW_END && (ticks - lastVBlankTicks) >= VBLANK_MIN_TICKS;
+    if(!isVBlank)return;
+    lastVBlankTicks = ticks;
+
+    // framebuffer swaps only happen here, never on a line
+    if(pendingOrigin) {
+      *VI_ORIGIN = pendingOrigin;
+      pendingOrigin = 0;
+    }
+    ++vblanks;
+
+    stats = statsFrame;
+    statsFrame = {};
+    lastLineTicks = 0;
+
+    lineRecordIdx ^= 1;
+    lineRecordCount[lineRecordIdx] = 0;
+
+    if(stopRequested) {
+      idxActive = NO_TABLE;
+      stopRequested = false;
+      liveActive = false;
+    }
+    if(idxPending != NO_TABLE) {
+      idxActive = idxPending;
+      idxPending = NO_TABLE;
+      liveActive = liveRequested;
+    }
+    // refilled by 'addLive' while this frame is scanned out
+    if(liveActive)tables[idxActive].count = 0;
+
+    if(vblankCallback)vblankCallback();
+    nextWrite = 0;
+    armNext();
+  }
+}
+
+void VITimeline::init(void(*onVBlank)())
+{
+  disable_interrupts();
+    vblankCallback = onVBlank;
+    register_VI_handler(onInterrupt);
+    set_VI_interrupt(1, VI_V_CURRENT_VBLANK);
+  enable_interrupts();
+}
+
+void VITimeline::show(const surface_t *fb)
+{
+  disable_interrupts();
+    pendingOrigin = PhysicalAddr(fb->buffer);
+  enable_interrupts();
+}
+
+void VITimeline::waitVBlank()
+{
+  uint32_t start = vblanks;
+  while(vblanks == start){}
+}
+
+void VITimeline::begin()
+{
+  tables[idxBuild].count = 0;
+}
+
+void VITimeline::add(uint32_t line, volatile uint32_t *reg, uint32_t value)
+{
+  auto &table = tables[idxBuild];
+  assertf(table.count < MAX_WRITES, "VITimeline: too many writes");
+  assertf(line > VI_V_CURRENT_VBLANK, "VITimeline: line %lu is before the vblank", line);
+  assertf((line & 1) == 0 && line < V_TOTAL, "VITimeline: line %lu is odd or past the frame", line);
+  table.writes[table.count++] = {reg, value, line};
+}
+
+void VITimeline::submit()
+{
+  disable_interrupts();
+    idxPending = idxBuild;
+    stopRequested = false;
+    liveRequested = false;
+    idxBuild = freeTable();
+  enable_interrupts();
+}
+
+void VITimeline::stop()
+{
+  disable_interrupts();
+    idxPending = NO_TABLE;
+    stopRequested = true;
+    liveRequested = false;
+    probe.armed = false;
+  enable_interrupts();
+}
+
+void VITimeline::beginLive()
+{
+  disable_interrupts();
+    tables[idxBuild].count = 0;
+    idxPending = idxBuild;
+    stopRequested = false;
+    liveRequested = true;
+    idxBuild = freeTable();
+  enable_interrupts();
+}
+
+void VITimeline::addLive(uint32_t line, volatile uint32_t *reg, uint32_t value)
+{
+  assertf(line > VI_V_CURRENT_VBLANK, "VITimeline: line %lu is before the vblank", line);
+  assertf((line & 1) == 0 && line < V_TOTAL, "VITimeline: line %lu is odd or past the frame", line);
+  disable_interrupts();
+    // before the vblank line, arming the interrupt now would skip the vblank of the next frame
+    if(!liveActive || *VI_V_CURRENT < VI_V_CURRENT_VBLANK) {
+      enable_interrupts();
+      return;
+    }
+
+    auto &table = tables[idxActive];
+    assertf(table.count < MAX_WRITES, "VITimeline: too many writes");
+    table.writes[table.count++] = {reg, value, line};
+
+    // chain already ran out, otherwise the pending interrupt picks it up
+    if(armedLine == VI_V_CURRENT_VBLANK)armNext();
+  enable_interrupts();
+}
+
+void VITimeline::armProbe(uint32_t line, volatile uint32_t *reg, uint32_t value)
+{
+  disable_interrupts();
+    probe = {.reg = reg, .line = line, .value = value, .ticks = 0, .armed = true};
+  enable_interrupts();
+}
+
+uint64_t VITimeline::getProbeTicks()
+{
+  disable_interrupts();
+    auto res = probe.ticks;
+  enable_interrupts();
+  return res;
+}
+
+VITimeline::Stats VITimeline::getStats()
+{
+  disable_interrupts();
+    auto res = stats;
+  enable_interrupts();
+  return res;
+}
+
+void VITimeline::setRecording(bool enabled)
+{
+  disable_interrupts();
+    recording = enabled;
+    histogram = {};
+    lineRecordCount[0] = lineRecordCount[1] = 0;
+  enable_interrupts();
+}
+
+bool VITimeline::isRecording()
+{
+  return recording;
+}
+
+VITimeline::Histogram VITimeline::getHistogram()
+{
+  disable_interrupts();
+    auto res = histogram;
+  enable_interrupts();
+  return res;
+}
+
+void VITimeline::logRecording(const char* name)
+{
+  static LineRecord records[MAX_LINE_RECORDS];
+  disable_interrupts();
+    auto hist = histogram;
+    uint32_t count = lineRecordCount[lineRecordIdx ^ 1]; // last completed frame
+    memcpy(records, lineRecords[lineRecordIdx ^ 1], count * sizeof(LineRecord));
+  enable_interrupts();
+
+  debugf("{\"viHist\":\"%s\",\"bucketTicks\":%lu,\"samples\":%lu,\"missedLines\":%lu,\"maxTicks\":%lu,\"buckets\":[",
+    name, HIST_BUCKET_TICKS, hist.samples, hist.missedLines, hist.maxTicks
+  );
+  for(uint32_t i=0; i<HIST_BUCKETS; ++i)debugf(i ? ",%lu" : "%lu", hist.buckets[i]);
+  debugf("]}\n");
+
+  for(uint32_t i=0; i<count; ++i) {
+    auto &rec = records[i];
+    debugf("{\"viLine\":%u,\"lineAfter\":%u,\"ticksEntry\":%lu,\"ticksWrite\":%lu}\n",
+      rec.line, rec.lineAfter, rec.ticksEntry, rec.ticksWrite
+    );
+  }
+}
@@ -0,0 +1,104 @@
+/**
+* @copyright 2025 - Max Bebök
+* @license MIT
+*/
+#pragma once
+#include <libdragon.h>
+
+/**
+ * Per-line VI register writes, applied from a chain of VI line-interrupts.
+ * A demo fills the table for the next frame ('begin', 'add', 'submit'), which becomes active at the next vblank.
+ * The CPU is free between the lines, instead of busy-polling VI_V_CURRENT for the whole scan-out.
+ */
+namespace VITimeline
+{
+  constexpr uint32_t MAX_WRITES = 512;
+
+  struct Stats {
+    uint32_t interrupts{};  // line-interrupts taken in the last frame
+    uint32_t lateWrites{};  // writes done after VI_V_CURRENT already moved past their line
+    uint32_t handlerTicks{}; // max. ticks from entering the handler to the last write of a line
+    uint32_t lineTicksMin{}; // min./max. ticks between consecutive lines, the difference is the jitter
+    uint32_t lineTicksMax{};
+  };
+
+  constexpr uint32_t HIST_BUCKETS = 16;
+  constexpr uint32_t HIST_BUCKET_TICKS = 64; // last bucket also takes everything above
+  constexpr uint32_t MAX_LINE_RECORDS = 256;
+
+  /**
+   * Latency of the writes of each line, in ticks from entering the line-interrupt to the last write.
+   * The dispatch of the interrupt itself is not included, lines passed before the write are counted as missed.
+   */
+  struct Histogram {
+    uint32_t buckets[HIST_BUCKETS]{};
+    uint32_t samples{};
+    uint32_t missedLines{};
+    uint32_t maxTicks{};
+  };
+
+  struct LineRecord {
+    uint16_t line;      // line of the table
+    uint16_t lineAfter; // VI_V_CURRENT after the writes
+    uint32_t ticksEntry;
+    uint32_t ticksWrite;
+  };
+
+  /**
+   * Takes over the VI interrupt, 'onVBlank' gets called once per frame (at VI_V_CURRENT_VBLANK).
+   * Replaces 'register_VI_handler' + 'set_VI_interrupt', which would otherwise run on every line too.
+   * libdragon's own VI handler still sees the line-interrupts, so the VI mode has to be set up before
+   * (e.g. a single 'vi_show' + 'vi_wait_vblank'), afterwards only 'show' and 'waitVBlank' should be used.
+   */
+  void init(void(*onVBlank)());
+
+  // shows 'fb' from the next vblank on, same format and size as the one set up before 'init'
+  void show(const surface_t *fb);
+
+  // waits for the next vblank, unlike 'vi_wait_vblank' a line-interrupt doesn't end the wait
+  void waitVBlank();
+
+  // starts a new table for the next frame
+  void begin();
+
+  /**
+   * Writes 'value' to 'reg' once VI_V_CURRENT reaches 'line' (in half-lines, after the vblank line).
+   * Lines must be added in ascending order, writes of the same line are done together.
+   */
+  void add(uint32_t line, volatile uint32_t *reg, uint32_t value);
+
+  // the table is used from the next vblank on, until another one is submitted or 'stop' is called
+  void submit();
+
+  // stops at the next vblank, registers keep the last written values
+  void stop();
+
+  /**
+   * Beam-racing: from the next vblank on, every frame starts with an empty table,
+   * filled via 'addLive' while it is scanned out. Ends with 'submit' or 'stop'.
+   */
+  void beginLive();
+
+  /**
+   * Appends a write to the frame that is currently scanned out, meant to be called just ahead of the VI.
+   * Lines already passed are written right away (as late writes), ignored until the live table is active.
+   */
+  void addLive(uint32_t line, volatile uint32_t *reg, uint32_t value);
+
+  /**
+   * Latency probe, captures the ticks of the first write to 'reg' at 'line' with a value other than 'value'.
+   * 'getProbeTicks' returns 0 until then, 'stop' disarms it.
+   */
+  void armProbe(uint32_t line, volatile uint32_t *reg, uint32_t value);
+  uint64_t getProbeTicks();
+
+  Stats getStats();
+
+  // opt-in, as it adds a few ticks per line. Enabling/disabling resets the histogram
+  void setRecording(bool enabled);
+  bool isRecording();
+  Histogram getHistogram();
+
+  // histogram and the line records of the last frame as JSON lines over the debug log
+  void logRecording(const char* name);
+}
@@ -0,0 +1,383 @@
+/**
+* @copyright 2025 - Max Bebök
+* @license MIT
+*
+* Verifies framebuffer dumps from the debug log against the references in the .test files of the assets folder.
+* This is a native replacement for running parseTestCase.mjs + testToPng.mjs per case,
+* logs of any size are streamed and cases get compared on all cores.
+*
+* Usage: dumpVerify [options] <log>...
+*   -r <dir>   reference directory (default: assets)
+*   -o <dir>   write diff PNGs for failed cases into this directory
+*   -a         also write PNGs for passing cases (needs -o)
+*   -w <dir>   write cases without a reference as new .test files
+*   -j <n>     worker threads (default: all cores)
+*/
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "testRegion.h"
+#include "png.h"
+
+namespace
+{
+  constexpr size_t READ_CHUNK_SIZE = 4 * 1024 * 1024;
+  constexpr size_t MAX_CASES_IN_FLIGHT = 64; // bounds memory for huge logs
+  constexpr int PNG_PANEL_GAP = 4;
+
+  enum class Status { PASS, FAIL, NO_REF, INCOMPLETE };
+  constexpr const char* STATUS_NAMES[] = {"PASS", "FAIL", "NO-REF", "INCOMPLETE"};
+
+  struct TestCase
+  {
+    uint32_t index{}; // position across all logs, keeps the summary in log order
+    std::string id{};
+    std::string source{};
+    std::vector<uint16_t> pixels{};
+  };
+
+  struct CaseResult
+  {
+    uint32_t index{};
+    std::string id{};
+    std::string source{};
+    Status status{};
+    uint32_t errors{};
+    int firstX{-1};
+    int firstY{-1};
+  };
+
+  struct Options
+  {
+    std::string refDir{"assets"};
+    std::string outDir{};
+    std::string writeDir{};
+    bool pngForAll{false};
+    uint32_t threads{0};
+    std::vector<std::string> logs{};
+  };
+
+  /**
+   * Bounded multi-consumer queue, the log reader blocks if workers fall behind.
+   */
+  class WorkQueue
+  {
+    std::mutex mtx{};
+    std::condition_variable cvPush{};
+    std::condition_variable cvPop{};
+    std::deque<TestCase> items{};
+    bool closed{false};
+
+    public:
+      void push(TestCase &&item)
+      {
+        std::unique_lock lock{mtx};
+        cvPush.wait(lock, [this]{ return items.size() < MAX_CASES_IN_FLIGHT; });
+        items.push_back(std::move(item));
+        cvPop.notify_one();
+      }
+
+      std::optional<TestCase> pop()
+      {
+        std::unique_lock lock{mtx};
+        cvPop.wait(lock, [this]{ return closed || !items.empty(); });
+        if(items.empty())return std::nullopt;
+        auto item = std::move(items.front());
+        items.pop_front();
+        cvPush.notify_one();
+        return item;
+      }
+
+      void close()
+      {
+        std::lock_guard lock{mtx};
+        closed = true;
+        cvPop.notify_all();
+      }
+  };
+
+  constexpr int hexVal(char c) {
+    if(c >= '0' && c <= '9')return c - '0';
+    if(c >= 'A' && c <= 'F')return c - 'A' + 10;
+    if(c >= 'a' && c <= 'f')return c - 'a' + 10;
+    return -1;
+  }
+
+  bool loadReference(const std::string &path, std::vector<uint16_t> &out)
+  {
+    FILE *f = fopen(path.c_str(), "rb");
+    if(!f)return false;
+
+    std::vector<uint8_t> data(TestRegion::PIXEL_COUNT * 2);
+    size_t size = fread(data.data(), 1, data.size(), f);
+    fclose(f);
+    if(size != data.size())return false;
+
+    out.resize(TestRegion::PIXEL_COUNT);
+    for(int i=0; i<TestRegion::PIXEL_COUNT; ++i) {
+      out[i] = (data[i*2] << 8) | data[i*2+1]; // stored as big-endian, same as the N64 framebuffer
+    }
+    return true;
+  }
+
+  void writeTestFile(const std::string &path, const std::vector<uint16_t> &pixels)
+  {
+    FILE *f = fopen(path.c_str(), "wb");
+    if(!f) {
+      fprintf(stderr, "Failed to write: %s\n", path.c_str());
+      return;
+    }
+    for(auto px : pixels) {
+      uint8_t bytes[2]{(uint8_t)(px >> 8), (uint8_t)px};
+      fwrite(bytes, 1, 2, f);
+    }
+    fclose(f);
+  }
+
+  /**
+   * Writes dump, reference and a diff-mask next to each other.
+   * In the mask, mismatches are red and matching pixels a darkened copy of the dump.
+   */
+  void writeDiffPNG(const std::string &path, const std::vector<uint16_t> &dump, const std::vector<uint16_t> *ref)
+  {
+    constexpr int W = TestRegion::WIDTH;
+    constexpr int H = TestRegion::HEIGHT;
+    int panels = ref ? 3 : 1;
+    int imgWidth = W * panels + PNG_PANEL_GAP * (panels-1);
+
+    std::vector<uint8_t> rgba(imgWidth * H * 4, 0);
+    auto setPx = [&](int x, int y, uint32_t col) {
+      uint8_t *p = &rgba[(y * imgWidth + x) * 4];
+      p[0] = col >> 24; p[1] = col >> 16; p[2] = col >> 8; p[3] = 0xFF;
+    };
+
+    for(int y=0; y<H; ++y) {
+      for(int x=0; x<W; ++x) {
+        uint16_t colDump = dump[y*W + x];
+        setPx(x, y, PNG::rgba16ToRGBA32(colDump));
+        if(!ref)continue;
+
+        uint16_t colRef = (*ref)[y*W + x];
+        setPx(x + W + PNG_PANEL_GAP, y, PNG::rgba16ToRGBA32(colRef));
+
+        uint32_t colMask = colDump == colRef
+          ? ((PNG::rgba16ToRGBA32(colDump) >> 2) & 0x3F3F3F00)
+          : 0xFF202000;
+        setPx(x + (W + PNG_PANEL_GAP) * 2, y, colMask);
+      }
+    }
+
+    if(!PNG::write(path, rgba.data(), imgWidth, H)) {
+      fprintf(stderr, "Failed to write: %s\n", path.c_str());
+    }
+  }
+
+  CaseResult verifyCase(const Options &opt, const TestCase &tc)
+  {
+    CaseResult res{.index = tc.index, .id = tc.id, .source = tc.source};
+
+    if(tc.pixels.size() != (size_t)TestRegion::PIXEL_COUNT) {
+      res.status = Status::INCOMPLETE;
+      res.errors = TestRegion::PIXEL_COUNT - tc.pixels.size();
+      return res;
+    }
+
+    std::vector<uint16_t> ref{};
+    if(!loadReference(opt.refDir + "/" + tc.id + ".test", ref))
+    {
+      res.status = Status::NO_REF;
+      if(!opt.writeDir.empty())writeTestFile(opt.writeDir + "/" + tc.id + ".test", tc.pixels);
+      if(!opt.outDir.empty() && opt.pngForAll)writeDiffPNG(opt.outDir + "/" + tc.id + ".png", tc.pixels, nullptr);
+      return res;
+    }
+
+    for(int i=0; i<TestRegion::PIXEL_COUNT; ++i) {
+      if(tc.pixels[i] != ref[i]) {
+        if(res.errors == 0) {
+          res.firstX = TestRegion::X0 + (i % TestRegion::WIDTH);
+          res.firstY = TestRegion::Y0 + (i / TestRegion::WIDTH);
+        }
+        ++res.errors;
+      }
+    }
+
+    res.status = res.errors ? Status::FAIL : Status::PASS;
+    if(!opt.outDir.empty() && (res.errors || opt.pngForAll)) {
+      // the same case may be dumped multiple times, keep them apart
+      writeDiffPNG(opt.outDir + "/" + tc.id + "_" + std::to_string(tc.index) + ".png", tc.pixels, &ref);
+    }
+    return res;
+  }
+
+  /**
+   * Splits a log into test-cases: a 'TEST=<id>' line starts a case,
+   * lines made up of only hex-digits are pixel data (4 digits each).
+   * Anything else (e.g. '[Debug]' prefixes, JSON from headless runs) is ignored.
+   */
+  class LogSplitter
+  {
+    WorkQueue &queue;
+    uint32_t &caseIndex;
+    std::string source{};
+    std::optional<TestCase> curr{};
+
+    void flush() {
+      if(curr) {
+        queue.push(std::move(*curr));
+        curr.reset();
+      }
+    }
+
+    void parseLine(const char* line, size_t len)
+    {
+      while(len && (line[len-1] == '\r' || line[len-1] == ' ' || line[len-1] == '\t'))--len;
+      while(len && (*line == ' ' || *line == '\t')) { ++line; --len; }
+      if(len == 0)return;
+
+      if(len > 5 && memcmp(line, "TEST=", 5) == 0) {
+        flush();
+        std::string id{line + 5, len - 5};
+        std::transform(id.begin(), id.end(), id.begin(), ::toupper);
+        curr = TestCase{.index = caseIndex++, .id = id, .source = source};
+        curr->pixels.reserve(TestRegion::PIXEL_COUNT);
+        return;
+      }
+
+      if(!curr || (len % 4) != 0)return;
+      for(size_t i=0; i<len; ++i) {
+        if(hexVal(line[i]) < 0)return;
+      }
+
+      for(size_t i=0; i<len && curr->pixels.size() < (size_t)TestRegion::PIXEL_COUNT; i+=4) {
+        curr->pixels.push_back(
+          (hexVal(line[i]) << 12) | (hexVal(line[i+1]) << 8) | (hexVal(line[i+2]) << 4) | hexVal(line[i+3])
+        );
+      }
+    }
+
+    public:
+      LogSplitter(WorkQueue &queue, uint32_t &caseIndex)
+        : queue{queue}, caseIndex{caseIndex} {}
+
+      bool process(const std::string &path)
+      {
+        FILE *f = fopen(path.c_str(), "rb");
+        if(!f) {
+          fprintf(stderr, "Failed to open log: %s\n", path.c_str());
+          return false;
+        }
+        source = path;
+
+        std::vector<char> buff(READ_CHUNK_SIZE);
+        std::string rest{};
+        size_t size;
+        while((size = fread(buff.data(), 1, buff.size(), f)) > 0)
+        {
+          const char* start = buff.data();
+          const char* end = start + size;
+          for(const char* p = start; p < end; ++p)
+          {
+            if(*p != '\n')continue;
+            if(rest.empty()) {
+              parseLine(start, p - start);
+            } else {
+              rest.append(start, p - start);
+              parseLine(rest.data(), rest.size());
+              rest.clear();
+            }
+            start = p + 1;
+          }
+          rest.append(start, end - start);
+        }
+        if(!rest.empty())parseLine(rest.data(), rest.size());
+
+        fclose(f);
+        flush(); // cases never span multiple logs
+        return true;
+      }
+  };
+
+  bool parseArgs(int argc, char** argv, Options &opt)
+  {
+    for(int i=1; i<argc; ++i)
+    {
+      std::string arg{argv[i]};
+      bool hasValue = (i+1) < argc;
+      if(arg == "-r" && hasValue)opt.refDir = argv[++i];
+      else if(arg == "-o" && hasValue)opt.outDir = argv[++i];
+      else if(arg == "-w" && hasValue)opt.writeDir = argv[++i];
+      else if(arg == "-j" && hasValue)opt.threads = std::stoul(argv[++i]);
+      else if(arg == "-a")opt.pngForAll = true;
+      else if(!arg.empty() && arg[0] == '-')return false;
+      else opt.logs.push_back(arg);
+    }
+    return !opt.logs.empty();
+  }
+}
+
+int main(int argc, char** argv)
+{
+  Options opt{};
+  if(!parseArgs(argc, argv, opt)) {
+    fprintf(stderr, "Usage: %s [-r refDir] [-o pngDir] [-a] [-w newRefDir] [-j threads] <log>...\n", argv[0]);
+    return 2;
+  }
+
+  if(opt.threads == 0)opt.threads = std::max(1u, std::thread::hardware_concurrency());
+
+  WorkQueue queue{};
+  std::mutex resMtx{};
+  std::vector<CaseResult> results{};
+
+  std::vector<std::thread> workers{};
+  for(uint32_t t=0; t<opt.threads; ++t) {
+    workers.emplace_back([&] {
+      while(auto tc = queue.pop()) {
+        auto res = verifyCase(opt, *tc);
+        std::lock_guard lock{resMtx};
+        results.push_back(std::move(res));
+      }
+    });
+  }
+
+  uint32_t caseIndex = 0;
+  bool logsOk = true;
+  LogSplitter splitter{queue, caseIndex};
+  for(auto &log : opt.logs) {
+    logsOk = splitter.process(log) && logsOk;
+  }
+
+  queue.close();
+  for(auto &w : workers)w.join();
+
+  std::sort(results.begin(), results.end(), [](auto &a, auto &b) { return a.index < b.index; });
+
+  uint32_t count[4]{};
+  printf("%-10s %-10s %7s  %-9s  %s\n", "Case", "Status", "Errors", "First", "Log");
+  for(auto &res : results)
+  {
+    ++count[(int)res.status];
+    char first[16]{"-"};
+    if(res.firstX >= 0)snprintf(first, sizeof(first), "%d,%d", res.firstX, res.firstY);
+    printf("%-10s %-10s %7u  %-9s  %s\n",
+      res.id.c_str(), STATUS_NAMES[(int)res.status], res.errors, first, res.source.c_str()
+    );
+  }
+
+  printf("\nTotal: %zu | Pass: %u | Fail: %u | No-Ref: %u | Incomplete: %u\n",
+    results.size(), count[(int)Status::PASS], count[(int)Status::FAIL],
+    count[(int)Status::NO_REF], count[(int)Status::INCOMPLETE]
+  );
+
+  bool failed = count[(int)Status::FAIL] || count[(int)Status::INCOMPLETE] || !logsOk;
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,176 @@
+/**
+* @copyright 2025 - Max Bebök
+* @license MIT
+*/
+#include "edgeWalker.h"
+#include <algorithm>
+
+namespace
+{
+  constexpr int32_t sign(uint32_t value, uint32_t bits) {
+    return (int32_t)(value << (32 - bits)) >> (32 - bits);
+  }
+
+  /**
+   * Converts an edge position (s15.16) to 1/8th pixels clamped to the scissor,
+   * the lowest bit is set if any fractional bits got truncated.
+   */
+  struct ScissorX { int32_t x; bool under; bool over; };
+
+  ScissorX scissorX(int32_t x, int32_t clipXHShift, int32_t clipXLShift)
+  {
+    int32_t sticky = ((x >> 1) & 0x1FFF) > 0;
+    int32_t xsc = ((x >> 13) & 0x1FFE) | sticky;
+    bool under = (x & 0x8000000) || (xsc < clipXHShift && !(x & 0x4000000));
+    xsc = under ? clipXHShift : (((x >> 13) & 0x3FFE) | sticky);
+    bool over = (xsc & 0x2000) || (xsc & 0x1FFF) >= clipXLShift;
+    xsc = over ? clipXLShift : xsc;
+    return {xsc & 0x1FFF, under, over};
+  }
+
+  bool edgesCross(int32_t xLeft, int32_t xRight) {
+    constexpr int32_t MASK = 0x3FFF << 14;
+    return ((xLeft ^ (1 << 27)) & MASK) < ((xRight ^ (1 << 27)) & MASK);
+  }
+}
+
+EdgeWalker::Shade EdgeWalker::decodeShade(const uint64_t *words)
+{
+  // integer and fractional parts are stored in separate words, 16bit per channel
+  auto combine = [](uint64_t intWord, uint64_t fracWord, int ch) {
+    uint32_t shift = 48 - ch * 16;
+    return (int32_t)((((intWord >> shift) & 0xFFFF) << 16) | ((fracWord >> shift) & 0xFFFF));
+  };
+
+  Shade s{};
+  for(int ch=0; ch<4; ++ch) {
+    s.rgba[ch] = combine(words[0], words[2], ch);
+    s.dx[ch]   = combine(words[1], words[3], ch);
+    s.de[ch]   = combine(words[4], words[6], ch);
+    s.dy[ch]   = combine(words[5], words[7], ch);
+  }
+  return s;
+}
+
+EdgeWalker::Result EdgeWalker::walk(const uint64_t *ew, const Clip &clip, const Shade *shade, std::vector<Span> &spans)
+{
+  uint32_t w0 = ew[0] >> 32;
+  uint32_t w1 = (uint32_t)ew[0];
+
+  bool flip = (w0 >> 23) & 1;
+  int32_t yl = sign(w0, 14);
+  int32_t ym = sign(w1 >> 16, 14);
+  int32_t yh = sign(w1, 14);
+
+  int32_t xl = sign(ew[1] >> 32, 30);
+  int32_t xh = sign(ew[2] >> 32, 30);
+  int32_t xm = sign(ew[3] >> 32, 30);
+  int32_t dxldy = (int32_t)ew[1];
+  int32_t dxhdy = (int32_t)ew[2];
+  int32_t dxmdy = (int32_t)ew[3];
+
+  // edges are stepped per sub-scanline (1/4th of a line)
+  int32_t xRight = xh & ~1;
+  int32_t xLeft = xm & ~1;
+  int32_t xRightInc = (dxhdy >> 2) & ~1;
+  int32_t xLeftInc = (dxmdy >> 2) & ~1;
+
+  // shade is sampled once per line, on the sub-scanline closest to the major edge
+  bool signDxhdy = dxhdy < 0;
+  int32_t sampleSubLine = (signDxhdy != flip) ? 0 : 3;
+  Shade attr{};
+  int32_t attrOffset[4]{};
+  int32_t attrDxh[4]{};
+  if(shade)
+  {
+    attr = *shade;
+    for(int ch=0; ch<4; ++ch) {
+      attrDxh[ch] = (attr.dx[ch] >> 8) & ~1;
+      if(signDxhdy == flip) {
+        int32_t deh = (attr.de[ch] >> 9) & ~1;
+        int32_t dyh = (attr.dy[ch] >> 9) & ~1;
+        attrOffset[ch] = deh - (deh >> 2) - dyh + (dyh >> 2);
+      }
+    }
+  }
+
+  int32_t yLimitL = std::min(yl, clip.yl);
+  int32_t yLimitH = std::max(yh, clip.yh);
+  int32_t yFar = yLimitL | 3;
+  int32_t yClose = yLimitH & ~3;
+  int32_t clipXHShift = clip.xh << 1;
+  int32_t clipXLShift = clip.xl << 1;
+
+  Span span{};
+  int32_t spanMin = 0, spanMax = 0;
+  bool allOver = true, allUnder = true, allInvalid = true;
+
+  for(int32_t k = yh & ~3; k <= yFar; ++k)
+  {
+    if(k == ym) {
+      xLeft = xl & ~1;
+      xLeftInc = (dxldy >> 2) & ~1;
+    }
+
+    int32_t subLine = k & 3;
+    int32_t line = k >> 2;
+
+    if(k >= yClose && line >= 0 && line < (int32_t)spans.size())
+    {
+      if(subLine == 0) {
+        span = {};
+        spanMin = 0xFFF;
+        spanMax = 0;
+        allOver = allUnder = allInvalid = true;
+      }
+
+      auto major = scissorX(xRight, clipXHShift, clipXLShift);
+      auto minor = scissorX(xLeft, clipXHShift, clipXLShift);
+      span.majorX[subLine] = major.x;
+      span.minorX[subLine] = minor.x;
+      allOver = allOver && major.over && minor.over;
+      allUnder = allUnder && major.under && minor.under;
+
+      bool invalid = k < yLimitH || k >= yLimitL
+        || (flip ? edgesCross(xLeft, xRight) : edgesCross(xRight, xLeft));
+      span.invalid[subLine] = invalid;
+      allInvalid = allInvalid && invalid;
+
+      // the span is the union of all valid sub-scanlines
+      if(!invalid) {
+        int32_t left  = ((flip ? major.x : minor.x) >> 3) & 0xFFF;
+        int32_t right = ((flip ? minor.x : major.x) >> 3) & 0xFFF;
+        spanMin = std::min(spanMin, left);
+        spanMax = std::max(spanMax, right);
+      }
+
+      if(subLine == sampleSubLine) {
+        span.unscrx = sign(xRight >> 16, 12);
+        int32_t xFrac = (xRight >> 8) & 0xFF;
+        for(int ch=0; ch<4; ++ch) {
+          span.rgba[ch] = ((attr.rgba[ch] & ~0x1FF) + attrOffset[ch] - xFrac * attrDxh[ch]) & ~0x3FF;
+        }
+      }
+
+      if(subLine == 3) {
+        span.lx = spanMin;
+        span.rx = spanMax;
+        span.valid = !allInvalid && !allOver && !allUnder;
+        spans[line] = span;
+      }
+    }
+
+    if(subLine == 3) {
+      for(int ch=0; ch<4; ++ch)attr.rgba[ch] += attr.de[ch];
+    }
+
+    xLeft += xLeftInc;
+    xRight += xRightInc;
+  }
+
+  return {
+    .flip = flip,
+    .yStart = std::max(yLimitH >> 2, 0),
+    .yEnd = std::min(yLimitL >> 2, (int32_t)spans.size() - 1),
+  };
+}
@@ -0,0 +1,57 @@
+/**
+* @copyright 2025 - Max Bebök
+* @license MIT
+*/
+#pragma once
+#include <cstdint>
+#include <vector>
+
+/**
+ * Edge-walker of the RDP, shared by the software models in tools/host.
+ * Turns the edge words of a triangle command into one span per scanline,
+ * stepping all edges (and shade) with the same fixed-point arithmetic as the hardware.
+ */
+namespace EdgeWalker
+{
+  // scissor in 10.2 fixed-point, 'xl' and 'yl' are exclusive
+  struct Clip {
+    int32_t xh{}, yh{}, xl{}, yl{};
+  };
+
+  // shade coefficients in s15.16, decoded from the 8 shade words of a triangle
+  struct Shade {
+    int32_t rgba[4]{};
+    int32_t dx[4]{};
+    int32_t de[4]{};
+    int32_t dy[4]{};
+  };
+
+  struct Span {
+    int32_t lx{};     // first pixel (inclusive)
+    int32_t rx{};     // last pixel (inclusive)
+    int32_t unscrx{}; // major edge in pixels before scissoring, origin of the shade values
+    int32_t majorX[4]{}; // per sub-scanline in 1/8th pixels
+    int32_t minorX[4]{};
+    bool invalid[4]{};   // sub-scanline outside the triangle or scissor
+    bool valid{};
+    int32_t rgba[4]{};   // shade at 'unscrx' (s15.16)
+  };
+
+  struct Result {
+    bool flip{};   // left-major, spans are drawn left to right
+    int32_t yStart{};
+    int32_t yEnd{}; // inclusive
+  };
+
+  /**
+   * Walks a triangle, 'spans' is indexed by the scanline and must cover the scissor.
+   * @param ew the 4 edge words: (flip, yl, ym, yh), (xl, dxldy), (xh, dxhdy), (xm, dxmdy)
+   * @param shade optional shade coefficients
+   */
+  Result walk(const uint64_t *ew, const Clip &clip, const Shade *shade, std::vector<Span> &spans);
+
+  /**
+   * Decodes the shade words following the edge words of a shaded triangle.
+   */
+  Shade decodeShade(const uint64_t *words);
+}
@@ -0,0 +1,83 @@
+/**
+* @copyright 2025 - Max Bebök
+* @license MIT
+*
+* Runs the CPU micro-benchmarks of src/bench.h natively against the libdragon shim.
+* Reports ns/op and heap allocations/op, for profiling run it under perf/valgrind.
+*
+* Usage: hostBench [-t ms] [name-filter]
+*   -t <ms>   minimum measuring time per kernel (default: 200)
+*/
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <string>
+
+#include <libdragon.h>
+#include "main.h"
+#include "bench.h"
+
+State state{};
+
+namespace
+{
+  constinit uint64_t allocCount{};
+  surface_t fb = surface_make(HostShim::fromPhysical(0x30'0000), FMT_RGBA16, SCREEN_WIDTH, SCREEN_HEIGHT, 0x800);
+}
+
+// every heap allocation is counted, e.g. the command vectors of the RDP encoders
+void* operator new(size_t size)
+{
+  ++allocCount;
+  if(void* ptr = malloc(size))return ptr;
+  throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept { free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { free(ptr); }
+
+int main(int argc, char** argv)
+{
+  double minTimeMs = 200;
+  const char* filter = nullptr;
+  for(int i=1; i<argc; ++i) {
+    std::string arg{argv[i]};
+    if(arg == "-t" && i+1 < argc)minTimeMs = strtod(argv[++i], nullptr);
+    else if(arg[0] == '-') {
+      fprintf(stderr, "Usage: %s [-t ms] [name-filter]\n", argv[0]);
+      return 2;
+    }
+    else filter = argv[i];
+  }
+
+  state.fb = &fb;
+
+  printf("%-18s %12s %10s %12s\n", "Kernel", "ns/op", "allocs/op", "iterations");
+  for(auto &kernel : Bench::kernels())
+  {
+    if(filter && !strstr(kernel.name, filter))continue;
+    kernel.run(kernel.iterations); // warm-up
+
+    // grow the iteration count until the run is long enough to be stable
+    uint64_t iterations = kernel.iterations;
+    double elapsedNs = 0;
+    uint64_t allocs = 0;
+    for(;;)
+    {
+      uint64_t allocStart = allocCount;
+      auto start = std::chrono::steady_clock::now();
+      kernel.run(iterations);
+      elapsedNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+      allocs = allocCount - allocStart;
+
+      if(elapsedNs >= minTimeMs * 1e6 || iterations >= (1ull << 31))break;
+      iterations *= 2;
+    }
+
+    printf("%-18s %12.2f %10.2f %12llu\n", kernel.name,
+      elapsedNs / iterations, (double)allocs / iterations, (unsigned long long)iterations
+    );
+  }
+  return 0;
+}
@@ -0,0 +1,117 @@
+/**
+* @copyright 2025 - Max Bebök
+* @license MIT
+*/
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * Minimal dependency-free PNG writer (RGBA8, uncompressed deflate blocks).
+ * Only meant for debug/diff output of the host tools, files are not small.
+ */
+namespace PNG
+{
+  namespace Detail
+  {
+    inline uint32_t crc32(const uint8_t *data, size_t size, uint32_t crc = 0)
+    {
+      static const auto TABLE = []{
+        std::vector<uint32_t> t(256);
+        for(uint32_t n=0; n<256; ++n) {
+          uint32_t c = n;
+          for(int k=0; k<8; ++k)c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+          t[n] = c;
+        }
+        return t;
+      }();
+
+      crc = ~crc;
+      for(size_t i=0; i<size; ++i)crc = TABLE[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+      return ~crc;
+    }
+
+    inline void putU32(std::vector<uint8_t> &out, uint32_t v) {
+      out.push_back(v >> 24); out.push_back(v >> 16);
+      out.push_back(v >> 8);  out.push_back(v);
+    }
+
+    inline void putChunk(std::vector<uint8_t> &out, const char* type, const std::vector<uint8_t> &data)
+    {
+      putU32(out, data.size());
+      size_t crcStart = out.size();
+      out.insert(out.end(), type, type + 4);
+      out.insert(out.end(), data.begin(), data.end());
+      putU32(out, crc32(&out[crcStart], out.size() - crcStart));
+    }
+  }
+
+  /**
+   * Encodes an RGBA8 image (4 bytes per pixel, no padding) into a PNG file in memory.
+   */
+  inline std::vector<uint8_t> encode(const uint8_t *rgba, uint32_t width, uint32_t height)
+  {
+    using namespace Detail;
+
+    std::vector<uint8_t> raw;
+    raw.reserve((width * 4 + 1) * height);
+    for(uint32_t y=0; y<height; ++y) {
+      raw.push_back(0); // filter: none
+      raw.insert(raw.end(), rgba + y*width*4, rgba + (y+1)*width*4);
+    }
+
+    // zlib stream with 'stored' deflate blocks
+    std::vector<uint8_t> zlib{0x78, 0x01};
+    uint32_t adlerA = 1, adlerB = 0;
+    for(size_t pos=0; pos < raw.size() || pos == 0; )
+    {
+      size_t len = raw.size() - pos;
+      if(len > 0xFFFF)len = 0xFFFF;
+      bool last = (pos + len) == raw.size();
+      zlib.push_back(last ? 1 : 0);
+      zlib.push_back(len & 0xFF); zlib.push_back(len >> 8);
+      zlib.push_back(~len & 0xFF); zlib.push_back((~len >> 8) & 0xFF);
+      for(size_t i=0; i<len; ++i) {
+        uint8_t b = raw[pos + i];
+        zlib.push_back(b);
+        adlerA = (adlerA + b) % 65521;
+        adlerB = (adlerB + adlerA) % 65521;
+      }
+      pos += len;
+      if(last)break;
+    }
+    putU32(zlib, (adlerB << 16) | adlerA);
+
+    std::vector<uint8_t> ihdr;
+    putU32(ihdr, width);
+    putU32(ihdr, height);
+    ihdr.insert(ihdr.end(), {8, 6, 0, 0, 0}); // 8bit, RGBA, deflate, no filter, no interlace
+
+    std::vector<uint8_t> out{0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    putChunk(out, "IHDR", ihdr);
+    putChunk(out, "IDAT", zlib);
+    putChunk(out, "IEND", {});
+    return out;
+  }
+
+  inline bool write(const std::string &path, const uint8_t *rgba, uint32_t width, uint32_t height)
+  {
+    auto data = encode(rgba, width, height);
+    FILE *f = fopen(path.c_str(), "wb");
+    if(!f)return false;
+    bool ok = fwrite(data.data(), 1, data.size(), f) == data.size();
+    fclose(f);
+    return ok;
+  }
+
+  // RGBA5551 (as used by the N64 framebuffer) to RGBA8
+  constexpr uint32_t rgba16ToRGBA32(uint16_t col) {
+    uint32_t r = ((col >> 11) & 0x1F) << 3;
+    uint32_t g = ((col >>  6) & 0x1F) << 3;
+    uint32_t b = ((col >>  1) & 0x1F) << 3;
+    uint32_t a = (col & 1) ? 0xFF : 0;
+    return (r << 24) | (g << 16) | (b << 8) | a;
+  }
+}
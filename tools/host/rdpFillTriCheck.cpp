@@ -0,0 +1,177 @@
+/**
+* @copyright 2025 - Max Bebök
+* @license MIT
+*
+* Renders the RDPFillTri test-cases with the software RDP (rdpSim) and compares them against assets/*.test.
+* Commands are built with the same src/rdp/rdp.h encoders as the ROM,
+* so changes to the command generation can be checked without a console.
+*
+* Usage: rdpFillTriCheck [options] [seed]...
+*   -r <dir>   reference directory (default: assets)
+*   -w <dir>   write the rendered cases as .test files
+*   -l         only compare cases the model covers (left-major), others are listed as 'SKIP'
+* Without seeds, all cases of the demo are checked.
+*
+* Any mismatch is a 'FAIL' and makes the run return 1.
+* Right-major triangles are not modelled (see rdpSim.h), their cases fail with the note 'right-major'.
+* So this is a regression check of the left-major cases, not a validation of all references.
+*/
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <libdragon.h>
+#include "rdp/rdp.h"
+#include "testGen.h"
+#include "testRegion.h"
+#include "rdpSim.h"
+
+namespace
+{
+  constexpr uint32_t FB_ADDR = 0x30'0000; // same as the first framebuffer on the console
+  constexpr uint32_t FB_WIDTH = 320;
+  constexpr uint32_t FB_HEIGHT = 240;
+  constexpr uint32_t FB_STRIDE = 0x800;
+
+  enum class Status { PASS, FAIL, NO_REF, SKIP };
+  constexpr const char* STATUS_NAMES[] = {"PASS", "FAIL", "NO-REF", "SKIP"};
+
+  struct Options
+  {
+    std::string refDir{"assets"};
+    std::string writeDir{};
+    std::vector<uint32_t> seeds{};
+    bool modelledOnly{false};
+  };
+
+  /**
+   * Same command sequence as Demo::RDPFillTri, without the syncs that only matter on hardware.
+   */
+  std::vector<uint64_t> buildCase(uint32_t seed, void* fb)
+  {
+    auto tri = TestGen::fillTri(seed);
+    constexpr auto &REGION = TestRegion::RECT;
+
+    std::vector<uint64_t> cmds{
+      RDP::setColorImage(fb, RDP::Format::RGBA, RDP::BBP::_16, FB_STRIDE/2),
+      RDP::setScissor(0, 0, FB_WIDTH-1, FB_HEIGHT-1),
+      RDP::setOtherModes(RDP::OtherMode().cycleType(RDP::CYCLE::FILL)),
+      RDP::setFillColor({0, 0, 0, 0}),
+      RDP::fillRect(0, 0, FB_WIDTH-1, FB_HEIGHT-1),
+
+      RDP::setFillColor({0x22, 0x22, 0x22, 0}),
+      RDP::setScissor(REGION[0], REGION[1], REGION[2], REGION[3]),
+      RDP::fillRect(REGION[0], REGION[1], REGION[2], REGION[3]),
+      RDP::setFillColorRaw(tri.fillColor),
+    };
+
+    auto triCmds = RDP::triangle(0,
+      {.pos = {tri.pos[0][0], tri.pos[0][1]}},
+      {.pos = {tri.pos[1][0], tri.pos[1][1]}},
+      {.pos = {tri.pos[2][0], tri.pos[2][1]}}
+    );
+    cmds.insert(cmds.end(), triCmds.begin(), triCmds.end());
+    return cmds;
+  }
+
+  std::vector<uint16_t> readRegion(const uint8_t *fb)
+  {
+    std::vector<uint16_t> pixels{};
+    pixels.reserve(TestRegion::PIXEL_COUNT);
+    for(int y=TestRegion::Y0; y<TestRegion::Y1; ++y) {
+      for(int x=TestRegion::X0; x<=TestRegion::X1; ++x) {
+        const uint8_t *px = fb + y*FB_STRIDE + x*2;
+        pixels.push_back((px[0] << 8) | px[1]);
+      }
+    }
+    return pixels;
+  }
+
+  bool readFile(const std::string &path, std::vector<uint8_t> &out)
+  {
+    FILE *f = fopen(path.c_str(), "rb");
+    if(!f)return false;
+    out.resize(TestRegion::PIXEL_COUNT * 2);
+    size_t size = fread(out.data(), 1, out.size(), f);
+    fclose(f);
+    return size == out.size();
+  }
+
+  bool parseArgs(int argc, char** argv, Options &opt)
+  {
+    for(int i=1; i<argc; ++i)
+    {
+      std::string arg{argv[i]};
+      bool hasValue = i+1 < argc;
+      if(arg == "-r" && hasValue)opt.refDir = argv[++i];
+      else if(arg == "-w" && hasValue)opt.writeDir = argv[++i];
+      else if(arg == "-l")opt.modelledOnly = true;
+      else if(!arg.empty() && arg[0] == '-')return false;
+      else opt.seeds.push_back(strtoul(arg.c_str(), nullptr, 16));
+    }
+    if(opt.seeds.empty())opt.seeds.assign(TestGen::FILL_TRI_SEEDS.begin(), TestGen::FILL_TRI_SEEDS.end());
+    return true;
+  }
+}
+
+int main(int argc, char** argv)
+{
+  Options opt{};
+  if(!parseArgs(argc, argv, opt)) {
+    fprintf(stderr, "Usage: %s [-r refDir] [-w outDir] [-l] [seed]...\n", argv[0]);
+    return 2;
+  }
+
+  uint8_t *fb = HostShim::rdram + FB_ADDR;
+  RDPSim sim{HostShim::rdram, HostShim::RDRAM_SIZE};
+
+  uint32_t count[4]{};
+  printf("%-10s %-7s %7s  %s\n", "Case", "Status", "Errors", "Note");
+  for(auto seed : opt.seeds)
+  {
+    char id[16];
+    snprintf(id, sizeof(id), "%08X", seed);
+
+    sim.resetStats();
+    sim.run(buildCase(seed, fb));
+    auto pixels = readRegion(fb);
+
+    if(!opt.writeDir.empty()) {
+      std::vector<uint8_t> data{};
+      for(auto px : pixels) {
+        data.push_back(px >> 8);
+        data.push_back(px);
+      }
+      FILE *f = fopen((opt.writeDir + "/" + id + ".test").c_str(), "wb");
+      if(f) {
+        fwrite(data.data(), 1, data.size(), f);
+        fclose(f);
+      }
+    }
+
+    std::vector<uint8_t> ref{};
+    uint32_t errors = 0;
+    bool modelled = sim.getStats().undefinedTris == 0;
+    Status status = Status::NO_REF;
+    if(opt.modelledOnly && !modelled) {
+      status = Status::SKIP;
+    } else if(readFile(opt.refDir + "/" + id + ".test", ref))
+    {
+      for(int i=0; i<TestRegion::PIXEL_COUNT; ++i) {
+        uint16_t refPx = (ref[i*2] << 8) | ref[i*2+1];
+        if(refPx != pixels[i])++errors;
+      }
+      status = errors == 0 ? Status::PASS : Status::FAIL;
+    }
+
+    ++count[(int)status];
+    const char* note = modelled ? "" : "right-major";
+    printf("%-10s %-7s %7u  %s\n", id, STATUS_NAMES[(int)status], errors, note);
+  }
+
+  printf("\nTotal: %zu | Pass: %u | Fail: %u | No-Ref: %u | Skip: %u\n",
+    opt.seeds.size(), count[(int)Status::PASS], count[(int)Status::FAIL],
+    count[(int)Status::NO_REF], count[(int)Status::SKIP]
+  );
+  return count[(int)Status::FAIL] ? 1 : 0;
+}
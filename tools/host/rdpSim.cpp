@@ -0,0 +1,163 @@
+/**
+* @copyright 2025 - Max Bebök
+* @license MIT
+*/
+#include "rdpSim.h"
+
+namespace
+{
+  namespace CMD {
+    constexpr uint32_t TRI_FILL      = 0x08; // 0x08-0x0F, lower bits are shade/tex/z
+    constexpr uint32_t FILL_RECT     = 0x36;
+    constexpr uint32_t FILL_COLOR    = 0x37;
+    constexpr uint32_t SCISSOR       = 0x2D;
+    constexpr uint32_t OTHER_MODES   = 0x2F;
+    constexpr uint32_t COLOR_IMAGE   = 0x3F;
+    constexpr uint32_t TEX_RECT      = 0x24;
+    constexpr uint32_t TEX_RECT_FLIP = 0x25;
+  }
+
+  constexpr uint32_t CYCLE_FILL = 3;
+  constexpr uint32_t BPP_8 = 1;
+  constexpr uint32_t BPP_16 = 2;
+  constexpr uint32_t BPP_32 = 3;
+
+  constexpr uint32_t field(uint64_t cmd, uint32_t startBit, uint32_t endBit) {
+    return (cmd >> endBit) & ((1ull << (startBit - endBit + 1)) - 1);
+  }
+
+  // amount of extra 64bit words following a triangle command
+  constexpr uint32_t triExtraWords(uint32_t cmd) {
+    uint32_t words = 3;
+    if(cmd & 0b100)words += 8; // shade
+    if(cmd & 0b010)words += 8; // texture
+    if(cmd & 0b001)words += 2; // depth
+    return words;
+  }
+}
+
+uint32_t RDPSim::run(const uint64_t *cmds, uint32_t count)
+{
+  uint32_t i = 0;
+  while(i < count)
+  {
+    uint64_t cmd = cmds[i];
+    uint32_t id = field(cmd, 61, 56);
+    ++stats.commands;
+
+    if((id & ~0b111) == CMD::TRI_FILL)
+    {
+      uint32_t size = 1 + triExtraWords(id);
+      if(i + size > count)break;
+
+      if(cycleType == CYCLE_FILL) {
+        ++stats.tris;
+        if(!field(cmd, 55, 55))++stats.undefinedTris;
+        edgeWalk(&cmds[i]);
+      } else {
+        ++stats.unsupported;
+      }
+      i += size;
+      continue;
+    }
+
+    switch(id)
+    {
+      case CMD::COLOR_IMAGE:
+        colorBpp = field(cmd, 52, 51);
+        colorWidth = field(cmd, 41, 32) + 1;
+        colorAddr = field(cmd, 25, 0);
+      break;
+
+      case CMD::SCISSOR:
+        clip = {
+          .xh = (int32_t)field(cmd, 55, 44),
+          .yh = (int32_t)field(cmd, 43, 32),
+          .xl = (int32_t)field(cmd, 23, 12),
+          .yl = (int32_t)field(cmd, 11, 0),
+        };
+      break;
+
+      case CMD::FILL_COLOR: fillColor = (uint32_t)cmd; break;
+      case CMD::OTHER_MODES: cycleType = field(cmd, 53, 52); break;
+
+      case CMD::FILL_RECT:
+      {
+        if(cycleType != CYCLE_FILL) {
+          ++stats.unsupported;
+          break;
+        }
+        ++stats.fillRects;
+
+        // rectangles go through the same edge-walker, as a left-major triangle
+        uint32_t xl = field(cmd, 55, 44);
+        uint32_t yl = field(cmd, 43, 32) | 3; // fill-mode includes the last line
+        uint32_t xh = field(cmd, 23, 12);
+        uint32_t yh = field(cmd, 11, 0);
+
+        uint64_t xlFixed = ((xl >> 2) << 16) | ((xl & 3) << 14);
+        uint64_t xhFixed = ((xh >> 2) << 16) | ((xh & 3) << 14);
+        uint64_t ew[4]{
+          ((uint64_t)0x3680 << 48) | ((uint64_t)yl << 32) | (yl << 16) | yh,
+          xlFixed << 32,
+          xhFixed << 32,
+          xlFixed << 32,
+        };
+        edgeWalk(ew);
+      }
+      break;
+
+      case CMD::TEX_RECT:
+      case CMD::TEX_RECT_FLIP:
+        ++stats.unsupported;
+        ++i;
+      break;
+
+      case 0x00: // no-op
+      case 0x26: case 0x27: case 0x28: case 0x29: // syncs
+      break;
+
+      default: ++stats.unsupported; break;
+    }
+    ++i;
+  }
+  return i;
+}
+
+void RDPSim::edgeWalk(const uint64_t *ew)
+{
+  auto res = EdgeWalker::walk(ew, clip, nullptr, spans);
+  renderSpans(res.yStart, res.yEnd);
+}
+
+void RDPSim::renderSpans(int32_t yStart, int32_t yEnd)
+{
+  for(int32_t y = yStart; y <= yEnd; ++y)
+  {
+    auto &span = spans[y];
+    if(!span.valid)continue;
+    for(int32_t x = span.lx; x <= span.rx; ++x) {
+      fillPixel(y, x);
+    }
+    span.valid = false;
+  }
+}
+
+void RDPSim::fillPixel(uint32_t y, uint32_t x)
+{
+  uint32_t idx = y * colorWidth + x;
+  uint32_t addr, size, value;
+  switch(colorBpp)
+  {
+    case BPP_8:  addr = colorAddr + idx;     size = 1; value = fillColor >> (8 * (3 - (x & 3))); break;
+    case BPP_16: addr = colorAddr + idx * 2; size = 2; value = (x & 1) ? fillColor : (fillColor >> 16); break;
+    case BPP_32: addr = colorAddr + idx * 4; size = 4; value = fillColor; break;
+    default: return;
+  }
+
+  addr &= 0xFF'FFFF;
+  if(addr + size > rdramSize)return;
+  for(uint32_t b=0; b<size; ++b) {
+    rdram[addr + b] = value >> (8 * (size - 1 - b)); // big-endian, as on the console
+  }
+}
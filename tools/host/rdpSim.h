@@ -0,0 +1,70 @@
+/**
+* @copyright 2025 - Max Bebök
+* @license MIT
+*/
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "edgeWalker.h"
+
+/**
+ * Software model of the RDP, executing the raw 64bit commands built by src/rdp/rdp.h.
+ * Only fill-mode is modelled: color-image, scissor, fill-color, other-modes (cycle type),
+ * fill-rectangles and non-textured triangles.
+ * Memory is a plain big-endian byte array, addressed by the physical addresses in the commands.
+ *
+ * Rasterization follows the hardware edge-walker (4 sub-scanlines, 1/8th pixel horizontal precision).
+ * Right-major triangles (flip=0) are only rasterized in their ideal form, which does not match the console.
+ * There, spans get mirrored masks in their end words, end words shifted or dropped, and whole lines missing.
+ * No rule from the edge-walker state reproduces all RDPFillTri references, so this is not modelled.
+ * Such commands are counted in 'Stats::undefinedTris'.
+ */
+class RDPSim
+{
+  public:
+    struct Stats {
+      uint32_t commands{};
+      uint32_t fillRects{};
+      uint32_t tris{};
+      uint32_t undefinedTris{}; // fill-mode triangles without a bit-exact model (see above)
+      uint32_t unsupported{};   // commands ignored by the model
+    };
+
+    RDPSim(uint8_t *rdram, uint32_t rdramSize)
+      : rdram{rdram}, rdramSize{rdramSize} {}
+
+    /**
+     * Executes a command list, each command can be followed by its extra words (e.g. triangles).
+     * @return number of words consumed
+     */
+    uint32_t run(const uint64_t *cmds, uint32_t count);
+
+    uint32_t run(const std::vector<uint64_t> &cmds) {
+      return run(cmds.data(), (uint32_t)cmds.size());
+    }
+
+    const Stats& getStats() const { return stats; }
+    void resetStats() { stats = {}; }
+
+  private:
+    uint8_t *rdram;
+    uint32_t rdramSize;
+
+    uint32_t colorAddr{};
+    uint32_t colorWidth{};
+    uint32_t colorBpp{};
+    uint32_t fillColor{};
+    uint32_t cycleType{};
+    EdgeWalker::Clip clip{};
+
+    Stats stats{};
+    std::vector<EdgeWalker::Span> spans = std::vector<EdgeWalker::Span>(1024);
+
+    /**
+     * Walks the edges of a triangle (or rectangle in triangle form) and fills the span per scanline.
+     * @param ew the 4 edge words: (flip, yl, ym, yh), (xl, dxldy), (xh, dxhdy), (xm, dxmdy)
+     */
+    void edgeWalk(const uint64_t *ew);
+    void renderSpans(int32_t yStart, int32_t yEnd);
+    void fillPixel(uint32_t y, uint32_t x);
+};
@@ -0,0 +1,287 @@
+/**
+* @copyright 2025 - Max Bebök
+* @license MIT
+*
+* Sweeps seeds of the RDP test-generators (src/testGen.h) on all cores and classifies
+* the triangle commands built by src/rdp/rdp.h by their geometric class.
+* Prints the coverage of the seeds currently used by the demos and a minimal set covering every class found.
+*
+* Usage: seedMinimizer [options]
+*   -s <fill|shade>  generator to sweep (default: fill)
+*   -n <count>       number of seeds (default: 16M)
+*   -j <threads>     worker threads (default: all cores)
+*   -x               track every class separately for left- and right-major triangles
+*/
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <libdragon.h>
+#include "rdp/rdp.h"
+#include "testGen.h"
+
+namespace
+{
+  constexpr int32_t SCREEN_W = 320;
+  constexpr int32_t SCREEN_H = 240;
+  // edges with more than this many pixels per line count as (almost) horizontal
+  constexpr int32_t STEEP_SLOPE = 64;
+
+  namespace Class {
+    constexpr uint64_t LEFT_MAJOR      = 1ull << 0;
+    constexpr uint64_t RIGHT_MAJOR     = 1ull << 1;
+    constexpr uint64_t DXHDY_NEG       = 1ull << 2;  // decides the sub-scanline shade is sampled on
+    constexpr uint64_t DXHDY_POS       = 1ull << 3;
+    constexpr uint64_t VERT_MAJOR      = 1ull << 4;
+    constexpr uint64_t VERT_MID        = 1ull << 5;
+    constexpr uint64_t VERT_LOW        = 1ull << 6;
+    constexpr uint64_t STEEP_MAJOR     = 1ull << 7;
+    constexpr uint64_t STEEP_MID       = 1ull << 8;
+    constexpr uint64_t STEEP_LOW       = 1ull << 9;
+    constexpr uint64_t FLAT_TOP        = 1ull << 10; // ym == yh
+    constexpr uint64_t FLAT_BOTTOM     = 1ull << 11; // ym == yl
+    constexpr uint64_t OFF_LEFT        = 1ull << 12;
+    constexpr uint64_t OFF_RIGHT       = 1ull << 13;
+    constexpr uint64_t OFF_TOP         = 1ull << 14;
+    constexpr uint64_t OFF_BOTTOM      = 1ull << 15;
+    constexpr uint64_t OFF_SCREEN      = 1ull << 16; // no pixel on screen
+    constexpr uint64_t NEG_X           = 1ull << 17; // edge starts at a negative X (sign bits in the command)
+    constexpr uint64_t EMPTY_Y         = 1ull << 18; // less than a line tall
+    constexpr uint32_t YH_FRAC_SHIFT   = 19; // 4 classes each, one per sub-scanline
+    constexpr uint32_t YM_FRAC_SHIFT   = 23;
+    constexpr uint32_t YL_FRAC_SHIFT   = 27;
+    constexpr uint32_t COUNT           = 31;
+    // with '-x', classes of right-major triangles are moved into the upper half
+    constexpr uint32_t RIGHT_SHIFT     = 32;
+  }
+
+  constexpr const char* CLASS_NAMES[Class::COUNT] = {
+    "left-major", "right-major", "dxhdy<0", "dxhdy>=0",
+    "vertical major", "vertical mid", "vertical low",
+    "steep major", "steep mid", "steep low",
+    "flat top", "flat bottom",
+    "off-left", "off-right", "off-top", "off-bottom", "off-screen", "negative x", "sub-line height",
+    "yh.00", "yh.25", "yh.50", "yh.75",
+    "ym.00", "ym.25", "ym.50", "ym.75",
+    "yl.00", "yl.25", "yl.50", "yl.75",
+  };
+
+  enum class Suite { FILL, SHADE };
+
+  struct Options {
+    Suite suite{Suite::FILL};
+    uint64_t count{1u << 24};
+    uint32_t threads{std::max(1u, std::thread::hardware_concurrency())};
+    bool perHandedness{false};
+  };
+
+  constexpr int32_t sign(uint32_t value, uint32_t bits) {
+    return (int32_t)(value << (32 - bits)) >> (32 - bits);
+  }
+
+  // spreads the sweep index over the seed range, xorshift starts badly on small seeds
+  constexpr uint32_t indexToSeed(uint64_t idx) {
+    uint32_t x = (uint32_t)idx + 0x9E37'79B9u;
+    x = (x ^ (x >> 16)) * 0x85EB'CA6Bu;
+    x = (x ^ (x >> 13)) * 0xC2B2'AE35u;
+    return x ^ (x >> 16);
+  }
+
+  std::vector<uint64_t> buildTri(Suite suite, uint32_t seed)
+  {
+    float pos[3][2];
+    if(suite == Suite::FILL) {
+      auto tri = TestGen::fillTri(seed);
+      std::copy(&tri.pos[0][0], &tri.pos[0][0] + 6, &pos[0][0]);
+    } else {
+      auto tri = TestGen::undefShadeTri(seed);
+      std::copy(&tri.pos[0][0], &tri.pos[0][0] + 6, &pos[0][0]);
+    }
+
+    return RDP::triangle(0,
+      {.pos = {pos[0][0], pos[0][1]}},
+      {.pos = {pos[1][0], pos[1][1]}},
+      {.pos = {pos[2][0], pos[2][1]}}
+    );
+  }
+
+  uint64_t classify(const std::vector<uint64_t> &cmds, bool perHandedness)
+  {
+    uint32_t w0 = cmds[0] >> 32;
+    uint32_t w1 = (uint32_t)cmds[0];
+    bool flip = (w0 >> 23) & 1;
+    int32_t yl = sign(w0, 14);
+    int32_t ym = sign(w1 >> 16, 14);
+    int32_t yh = sign(w1, 14);
+
+    int32_t xl = sign(cmds[1] >> 32, 30);
+    int32_t xh = sign(cmds[2] >> 32, 30);
+    int32_t xm = sign(cmds[3] >> 32, 30);
+    int32_t slopes[3]{(int32_t)cmds[2], (int32_t)cmds[3], (int32_t)cmds[1]}; // major, mid, low
+
+    uint64_t res = flip ? Class::LEFT_MAJOR : Class::RIGHT_MAJOR;
+    res |= slopes[0] < 0 ? Class::DXHDY_NEG : Class::DXHDY_POS;
+
+    for(int i=0; i<3; ++i) {
+      if(slopes[i] == 0)res |= Class::VERT_MAJOR << i;
+      if(std::abs(slopes[i] >> 16) >= STEEP_SLOPE)res |= Class::STEEP_MAJOR << i;
+    }
+    if(ym == yh)res |= Class::FLAT_TOP;
+    if(ym == yl)res |= Class::FLAT_BOTTOM;
+    if((yl >> 2) == (yh >> 2))res |= Class::EMPTY_Y;
+
+    // horizontal extent from the edge positions at the start and end of each edge
+    float heightHL = (yl - yh) / 4.0f;
+    float heightML = (yl - ym) / 4.0f;
+    float xs[5]{
+      xh / 65536.0f, xm / 65536.0f, xl / 65536.0f,
+      (xh + (float)slopes[0] * heightHL) / 65536.0f,
+      (xl + (float)slopes[2] * heightML) / 65536.0f,
+    };
+    auto [minX, maxX] = std::minmax_element(std::begin(xs), std::end(xs));
+
+    if(*minX < 0)res |= Class::OFF_LEFT;
+    if(*maxX >= SCREEN_W)res |= Class::OFF_RIGHT;
+    if(yh < 0)res |= Class::OFF_TOP;
+    if(yl >= SCREEN_H * 4)res |= Class::OFF_BOTTOM;
+    if(*maxX < 0 || *minX >= SCREEN_W || yl < 0 || yh >= SCREEN_H * 4)res |= Class::OFF_SCREEN;
+    if(xh < 0 || xm < 0 || xl < 0)res |= Class::NEG_X;
+
+    res |= 1ull << (Class::YH_FRAC_SHIFT + (yh & 3));
+    res |= 1ull << (Class::YM_FRAC_SHIFT + (ym & 3));
+    res |= 1ull << (Class::YL_FRAC_SHIFT + (yl & 3));
+
+    if(perHandedness && !flip) {
+      constexpr uint64_t HANDEDNESS = Class::LEFT_MAJOR | Class::RIGHT_MAJOR;
+      res = (res & HANDEDNESS) | ((res & ~HANDEDNESS) << Class::RIGHT_SHIFT);
+    }
+    return res;
+  }
+
+  // class-mask -> lowest sweep index that produced it
+  using MaskMap = std::unordered_map<uint64_t, uint64_t>;
+
+  void sweep(const Options &opt, uint64_t start, uint64_t end, MaskMap &out)
+  {
+    for(uint64_t i=start; i<end; ++i) {
+      auto mask = classify(buildTri(opt.suite, indexToSeed(i)), opt.perHandedness);
+      out.try_emplace(mask, i);
+    }
+  }
+
+  /**
+   * Greedy set-cover over the distinct class combinations,
+   * ties go to the earliest seed so the result is independent of the thread count.
+   */
+  std::vector<uint32_t> minimize(const MaskMap &masks, uint64_t allClasses)
+  {
+    std::vector<std::pair<uint64_t, uint64_t>> sorted(masks.begin(), masks.end());
+    std::sort(sorted.begin(), sorted.end(), [](auto &a, auto &b) { return a.second < b.second; });
+
+    std::vector<uint32_t> seeds{};
+    uint64_t covered = 0;
+    while(covered != allClasses)
+    {
+      const std::pair<uint64_t, uint64_t> *best = nullptr;
+      int bestCount = 0;
+      for(auto &entry : sorted) {
+        int count = std::popcount(entry.first & ~covered);
+        if(count > bestCount) {
+          best = &entry;
+          bestCount = count;
+        }
+      }
+      if(!best)break;
+      covered |= best->first;
+      seeds.push_back(indexToSeed(best->second));
+    }
+    return seeds;
+  }
+
+  bool parseArgs(int argc, char** argv, Options &opt)
+  {
+    for(int i=1; i<argc; ++i)
+    {
+      std::string arg{argv[i]};
+      if(arg == "-x") {
+        opt.perHandedness = true;
+        continue;
+      }
+      if(i+1 >= argc)return false;
+      std::string val{argv[++i]};
+
+      if(arg == "-s" && (val == "fill" || val == "shade"))opt.suite = val == "fill" ? Suite::FILL : Suite::SHADE;
+      else if(arg == "-n")opt.count = strtoull(val.c_str(), nullptr, 0);
+      else if(arg == "-j")opt.threads = std::max(1ul, strtoul(val.c_str(), nullptr, 0));
+      else return false;
+    }
+    return opt.count > 0;
+  }
+
+  void printClasses(const char* title, uint64_t mask)
+  {
+    printf("%s (%d):", title, std::popcount(mask));
+    for(uint32_t c=0; c<64; ++c) {
+      if(!(mask & (1ull << c)))continue;
+      bool right = c >= Class::RIGHT_SHIFT;
+      printf(" [%s%s]", right ? "R:" : "", CLASS_NAMES[c % Class::RIGHT_SHIFT]);
+    }
+    printf("\n");
+  }
+}
+
+int main(int argc, char** argv)
+{
+  Options opt{};
+  if(!parseArgs(argc, argv, opt)) {
+    fprintf(stderr, "Usage: %s [-s fill|shade] [-n count] [-j threads] [-x]\n", argv[0]);
+    return 2;
+  }
+
+  auto timeStart = std::chrono::steady_clock::now();
+
+  std::vector<MaskMap> results(opt.threads);
+  std::vector<std::thread> workers{};
+  uint64_t chunk = (opt.count + opt.threads - 1) / opt.threads;
+  for(uint32_t t=0; t<opt.threads; ++t) {
+    uint64_t start = std::min(opt.count, t * chunk);
+    uint64_t end = std::min(opt.count, start + chunk);
+    workers.emplace_back(sweep, std::cref(opt), start, end, std::ref(results[t]));
+  }
+  for(auto &w : workers)w.join();
+
+  MaskMap masks{};
+  uint64_t allClasses = 0;
+  for(auto &res : results) {
+    for(auto &[mask, idx] : res) {
+      auto [it, inserted] = masks.try_emplace(mask, idx);
+      if(!inserted)it->second = std::min(it->second, idx);
+      allClasses |= mask;
+    }
+  }
+
+  double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - timeStart).count();
+  printf("Swept %llu seeds on %u threads in %.2fs (%.1f M/s), %zu distinct combinations\n",
+    (unsigned long long)opt.count, opt.threads, secs, opt.count / secs / 1e6, masks.size()
+  );
+  printClasses("Reachable", allClasses);
+
+  auto &current = opt.suite == Suite::FILL ? TestGen::FILL_TRI_SEEDS : TestGen::UNDEF_SHADE_SEEDS;
+  uint64_t currentClasses = 0;
+  for(auto seed : current)currentClasses |= classify(buildTri(opt.suite, seed), opt.perHandedness);
+  printClasses("Current seeds", currentClasses);
+  printClasses("Missing", allClasses & ~currentClasses);
+
+  auto seeds = minimize(masks, allClasses);
+  printf("\nMinimal set (%zu seeds, current: %zu):\n", seeds.size(), current.size());
+  for(size_t i=0; i<seeds.size(); ++i) {
+    printf("%s0x%08xu,%s", (i % 5) == 0 ? "  " : " ", seeds[i], (i % 5) == 4 || i+1 == seeds.size() ? "\n" : "");
+  }
+  return 0;
+}
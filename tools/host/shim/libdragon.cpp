@@ -0,0 +1,108 @@
+/**
+* @copyright 2025 - Max Bebök
+* @license MIT
+*/
+#include <libdragon.h>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+  constexpr uint32_t HEAP_ALIGN = 16;
+
+  // offset -> size of all 'malloc_uncached' blocks
+  std::map<uint32_t, uint32_t> heapBlocks{};
+  std::mutex heapMutex{};
+
+  const auto timeStart = std::chrono::steady_clock::now();
+}
+
+void HostShim::invalidAddress(const void* addr)
+{
+  fprintf(stderr, "Address outside of the RDRAM arena: %p\n", addr);
+  abort();
+}
+
+void HostShim::dpSubmit()
+{
+  if(dpHandler)dpHandler(*DP_START, *DP_END);
+  *DP_CURRENT = *DP_END; // the list is always fully processed
+}
+
+void HostShim::miWrite(volatile void* addr, const void* data, uint32_t size)
+{
+  auto dst = (uint8_t*)addr;
+  auto src = (const uint8_t*)data;
+  uint32_t mode = *MI_MODE;
+
+  if(mode & MI_WMODE_SET_REPEAT) {
+    uint32_t len = (mode & 0x7F) + 1;
+    auto block = (uint8_t*)((uintptr_t)dst & ~(uintptr_t)0x7FF);
+    uint32_t offset = (uintptr_t)dst & 0x7FF;
+    // stores smaller than 64-bit count from the start of their doubleword, bytes in front of them are masked
+    uint32_t start = size < 8 ? (offset & ~0b111) : offset;
+
+    if(miRepeatHandler)miRepeatHandler(toPhysical(block) + start, len);
+    // a repeated write wraps around inside its 0x800 block
+    for(uint32_t pos=offset; pos < start + len; ++pos) {
+      block[pos & 0x7FF] = src[(pos - offset) % size];
+    }
+    *MI_MODE = 0; // repeat-mode only applies to a single write
+  } else {
+    memcpy(dst, src, size);
+  }
+}
+
+void HostShim::storeLeft(volatile void* addr, uint64_t value)
+{
+  uint32_t len = 8 - ((uintptr_t)addr & 0b111);
+  memcpy((void*)addr, &value, len);
+}
+
+uint64_t get_ticks()
+{
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - timeStart).count();
+  return (uint64_t)ns * (TICKS_PER_SECOND / 1000) / 1000'000;
+}
+
+void wait_ticks(uint64_t wait)
+{
+  std::this_thread::sleep_for(std::chrono::microseconds(TICKS_TO_US(wait)));
+}
+
+void wait_ms(unsigned long ms)
+{
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void* malloc_uncached(size_t size)
+{
+  return malloc_uncached_aligned(HEAP_ALIGN, size);
+}
+
+void* malloc_uncached_aligned(int align, size_t size)
+{
+  std::lock_guard lock{heapMutex};
+  size = (size + HEAP_ALIGN - 1) & ~(HEAP_ALIGN - 1);
+  auto alignUp = [align](uint32_t offset) { return (offset + align - 1) / align * align; };
+
+  // first-fit between the existing blocks
+  uint32_t offset = alignUp(HostShim::HEAP_START);
+  for(auto &[blockOffset, blockSize] : heapBlocks) {
+    if(offset + size <= blockOffset)break;
+    offset = alignUp(blockOffset + blockSize);
+  }
+  if(offset + size > HostShim::RDRAM_SIZE)return nullptr;
+
+  heapBlocks[offset] = size;
+  return HostShim::rdram + offset;
+}
+
+void free_uncached(void* buf)
+{
+  if(!buf)return;
+  std::lock_guard lock{heapMutex};
+  heapBlocks.erase(HostShim::toPhysical(buf));
+}
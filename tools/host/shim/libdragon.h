@@ -0,0 +1,207 @@
+/**
+* @copyright 2025 - Max Bebök
+* @license MIT
+*/
+#pragma once
+
+/**
+ * Host stand-in for libdragon, only provides what the shared sources in src/ need.
+ * Hardware registers (DP/MI/VI) are plain memory, RDRAM is a fixed 8MB arena.
+ * Memory written by the CPU is in host byte-order, only the RDP model (tools/host/rdpSim) writes big-endian.
+ */
+#define REP64_HOST 1
+
+// note: <math.h> would resolve to src/math.h, so C++ headers are used
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdarg>
+#include <cmath>
+#include <stdlib.h>
+
+typedef struct {
+  uint8_t r, g, b, a;
+} color_t;
+
+inline uint16_t color_to_packed16(color_t c) {
+  return (((int)c.r >> 3) << 11) | (((int)c.g >> 3) << 6) | (((int)c.b >> 3) << 1) | (c.a >> 7);
+}
+
+inline uint32_t color_to_packed32(color_t c) {
+  return ((uint32_t)c.r << 24) | ((uint32_t)c.g << 16) | ((uint32_t)c.b << 8) | c.a;
+}
+
+inline color_t color_from_packed16(uint16_t c) {
+  uint8_t r = (c >> 11) & 0x1F, g = (c >> 6) & 0x1F, b = (c >> 1) & 0x1F;
+  return {(uint8_t)((r << 3) | (r >> 2)), (uint8_t)((g << 3) | (g >> 2)), (uint8_t)((b << 3) | (b >> 2)), (uint8_t)((c & 1) ? 0xFF : 0)};
+}
+
+namespace HostShim {
+  // target of 'debugf', tests can point it to e.g. a 'tmpfile' to check the log without printing it
+  inline FILE* debugOut = stderr;
+}
+#define debugf(...) fprintf(HostShim::debugOut, __VA_ARGS__)
+
+#define assertf(cond, ...) do { if(!(cond)) { \
+  fprintf(stderr, "ASSERT: %s (%s:%d)\n", #cond, __FILE__, __LINE__); \
+  fprintf(stderr, __VA_ARGS__); fprintf(stderr, "\n"); abort(); } } while(0)
+
+#define MEMORY_BARRIER() asm volatile("" ::: "memory")
+
+#define _carg(value, mask, shift) (((uint32_t)((value) & (mask))) << (shift))
+
+inline float fm_floorf(float x) { return floorf(x); }
+inline float fm_fmodf(float x, float y) { return fmodf(x, y); }
+inline float fm_sinf(float x) { return sinf(x); }
+
+// ticks run at half the CPU clock, same as on the console
+#define TICKS_PER_SECOND (93750000/2)
+#define TICKS_FROM_US(val) ((val) * (TICKS_PER_SECOND / 1000000))
+#define TICKS_FROM_MS(val) ((val) * (TICKS_PER_SECOND / 1000))
+#define TICKS_TO_US(val) (((val) * 8) / (TICKS_PER_SECOND / 125000))
+#define TICKS_TO_MS(val) ((val) / (TICKS_PER_SECOND / 1000))
+
+uint64_t get_ticks();
+void wait_ticks(uint64_t wait);
+void wait_ms(unsigned long ms);
+
+// allocated inside the RDRAM arena, so the RDP commands can address it
+void* malloc_uncached(size_t size);
+void* malloc_uncached_aligned(int align, size_t size);
+void free_uncached(void* buf);
+
+typedef enum {
+  FMT_NONE = 0,
+  FMT_RGBA16 = 2,
+  FMT_RGBA32 = 3,
+} tex_format_t;
+
+typedef struct {
+  uint16_t flags;
+  uint16_t width;
+  uint16_t height;
+  uint16_t stride;
+  void *buffer;
+} surface_t;
+
+inline surface_t surface_make(void *buffer, tex_format_t format, uint16_t width, uint16_t height, uint16_t stride) {
+  return {(uint16_t)format, width, height, stride, buffer};
+}
+
+typedef enum { JOYPAD_PORT_1 = 0, JOYPAD_PORT_2, JOYPAD_PORT_3, JOYPAD_PORT_4 } joypad_port_t;
+
+typedef struct {
+  unsigned a : 1, b : 1, z : 1, start : 1;
+  unsigned d_up : 1, d_down : 1, d_left : 1, d_right : 1;
+  unsigned l : 1, r : 1;
+  unsigned c_up : 1, c_down : 1, c_left : 1, c_right : 1;
+} joypad_buttons_t;
+
+typedef struct {
+  joypad_buttons_t btn;
+  int8_t stick_x;
+  int8_t stick_y;
+} joypad_inputs_t;
+
+namespace HostShim
+{
+  constexpr uint32_t RDRAM_SIZE = 8 * 1024 * 1024;
+  // 'malloc_uncached' hands out memory from here to the end of RDRAM (after the framebuffers)
+  constexpr uint32_t HEAP_START = 0x50'0000;
+
+  // RDRAM stand-in, buffers the RDP accesses must live in here.
+  // Aligned to the MI-repeat wrap (0x800), so host and physical addresses share the same blocks
+  alignas(0x800) inline uint8_t rdram[RDRAM_SIZE]{};
+
+  [[noreturn]] void invalidAddress(const void* addr);
+
+  // constexpr only to satisfy the constexpr command builders in rdp.h, never evaluated at compile-time
+  constexpr uint32_t toPhysical(const void* addr) {
+    auto offset = (uintptr_t)addr - (uintptr_t)rdram;
+    if(offset >= RDRAM_SIZE)invalidAddress(addr);
+    return (uint32_t)offset;
+  }
+
+  // host pointer for a physical address, e.g. the fixed framebuffers at 0xA030'0000
+  inline void* fromPhysical(uint32_t addr) {
+    return rdram + (addr & 0x1FFF'FFFF);
+  }
+
+  inline volatile uint32_t dpRegs[8]{};
+  inline void (*dpHandler)(uint32_t start, uint32_t end){};
+
+  /**
+   * Writing DP_END starts the RDP on the console, 'RDP::DPL' calls this afterwards instead.
+   * Passes the command range to 'dpHandler' (if set), e.g. to run a software model.
+   */
+  void dpSubmit();
+
+  inline volatile uint32_t miRegs[4]{};
+  // called for each repeated write with the physical start address and length, e.g. to trace them in tests
+  inline void (*miRepeatHandler)(uint32_t addr, uint32_t len){};
+  inline volatile uint32_t viRegs[14]{};
+
+  // state returned by the joypad functions, set by the caller to simulate input
+  inline bool joypadConnected{false};
+  inline joypad_inputs_t joypadInputs{};
+  inline joypad_buttons_t joypadPressed{};
+
+  /**
+   * CPU store of 'size' bytes, honoring MI repeat-mode:
+   * if set in MI_MODE, the data is repeated over the configured length (up to 128 bytes) and the mode is cleared again.
+   * The repeat wraps inside its 0x800 block, stores below 64-bit start counting at their doubleword.
+   */
+  void miWrite(volatile void* addr, const void* data, uint32_t size);
+
+  // 'sdl': stores the bytes of 'value' up to the next 8-byte boundary
+  void storeLeft(volatile void* addr, uint64_t value);
+}
+
+#define DP_START     (&HostShim::dpRegs[0])
+#define DP_END       (&HostShim::dpRegs[1])
+#define DP_CURRENT   (&HostShim::dpRegs[2])
+#define DP_STATUS    (&HostShim::dpRegs[3])
+#define DP_CLOCK     (&HostShim::dpRegs[4])
+#define DP_BUSY      (&HostShim::dpRegs[5])
+#define DP_PIPE_BUSY (&HostShim::dpRegs[6])
+#define DP_TMEM_BUSY (&HostShim::dpRegs[7])
+
+#define DP_STATUS_DMA_BUSY  (1 << 8)
+#define DP_STATUS_PIPE_BUSY (1 << 5)
+
+#define MI_MODE      (&HostShim::miRegs[0])
+#define MI_VERSION   (&HostShim::miRegs[1])
+#define MI_INTERRUPT (&HostShim::miRegs[2])
+#define MI_MASK      (&HostShim::miRegs[3])
+
+#define MI_WMODE_CLR_REPEAT 0x0080
+#define MI_WMODE_SET_REPEAT 0x0100
+#define MI_WMODE_CLR_EBUS   0x0200
+#define MI_WMODE_SET_EBUS   0x0400
+
+#define VI_CTRL         (&HostShim::viRegs[0])
+#define VI_ORIGIN       (&HostShim::viRegs[1])
+#define VI_WIDTH        (&HostShim::viRegs[2])
+#define VI_V_INTR       (&HostShim::viRegs[3])
+#define VI_V_CURRENT    (&HostShim::viRegs[4])
+#define VI_BURST        (&HostShim::viRegs[5])
+#define VI_V_TOTAL      (&HostShim::viRegs[6])
+#define VI_H_TOTAL      (&HostShim::viRegs[7])
+#define VI_H_TOTAL_LEAP (&HostShim::viRegs[8])
+#define VI_H_VIDEO      (&HostShim::viRegs[9])
+#define VI_V_VIDEO      (&HostShim::viRegs[10])
+#define VI_V_BURST      (&HostShim::viRegs[11])
+#define VI_X_SCALE      (&HostShim::viRegs[12])
+#define VI_Y_SCALE      (&HostShim::viRegs[13])
+
+#define VI_V_CURRENT_VBLANK 2
+
+inline uint32_t PhysicalAddr(const void* addr) {
+  return HostShim::toPhysical(addr);
+}
+
+inline bool joypad_is_connected(joypad_port_t) { return HostShim::joypadConnected; }
+inline joypad_inputs_t joypad_get_inputs(joypad_port_t) { return HostShim::joypadInputs; }
+inline joypad_buttons_t joypad_get_buttons_held(joypad_port_t) { return HostShim::joypadInputs.btn; }
+inline joypad_buttons_t joypad_get_buttons_pressed(joypad_port_t) { return HostShim::joypadPressed; }
@@ -0,0 +1,141 @@
+/**
+* @copyright 2025 - Max Bebök
+* @license MIT
+*/
+#include "spanEval.h"
+#include "edgeWalker.h"
+#include <vector>
+
+namespace
+{
+  constexpr uint32_t SCREEN_WIDTH = 320; // same as src/main.h
+
+  // shade is kept with one extra bit to detect under- and overflows
+  constexpr uint32_t clamp9Bit(int32_t value) {
+    value &= 0x1FF;
+    if(value & 0x100)return (value & 0x80) ? 0 : 0xFF;
+    return value;
+  }
+
+  // (A-B)*C+D of the color-combiner, with B=D=0
+  constexpr uint32_t combine(uint32_t a, uint32_t c) {
+    return clamp9Bit((int32_t)((a * c + 0x80) >> 8));
+  }
+
+  // 2 samples per sub-scanline out of 4 positions (bit 3 = left), odd sub-scanlines are shifted by one
+  // samples right of a left edge at 'x' (1/8th pixels)
+  constexpr uint32_t rightCvg(int32_t x, uint32_t mask) {
+    return (0x0F >> (((x & 7) + 1) >> 1)) & mask;
+  }
+
+  // samples left of a right edge
+  constexpr uint32_t leftCvg(int32_t x, uint32_t mask) {
+    return (0xF0 >> (((x & 7) + 1) >> 1)) & mask;
+  }
+
+  /**
+   * Per-pixel coverage mask (4 sub-scanlines with 2 samples each) between 'lx' and 'rx'.
+   */
+  void computeCoverage(const EdgeWalker::Span &span, bool flip, std::array<uint8_t, 1024> &cvg)
+  {
+    for(int32_t x=span.lx; x<=span.rx; ++x)cvg[x] = 0xFF;
+
+    for(int i=0; i<4; ++i)
+    {
+      uint32_t mask = 0xA >> (i & 1);
+      uint32_t shift = (i - 2) & 4;
+      uint8_t clearMask = ~(mask << shift);
+
+      if(span.invalid[i]) {
+        for(int32_t x=span.lx; x<=span.rx; ++x)cvg[x] &= clearMask;
+        continue;
+      }
+
+      int32_t major = span.majorX[i];
+      int32_t minor = span.minorX[i];
+      // left and right edge of this sub-scanline, in 1/8th pixels
+      int32_t left  = flip ? major : minor;
+      int32_t right = flip ? minor : major;
+      int32_t leftInt = left >> 3;
+      int32_t rightInt = right >> 3;
+
+      for(int32_t x=span.lx; x<=leftInt; ++x)cvg[x] &= clearMask;
+      for(int32_t x=rightInt; x<=span.rx; ++x)cvg[x] &= clearMask;
+
+      if(rightInt > leftInt) {
+        cvg[leftInt] |= rightCvg(left, mask) << shift;
+        cvg[rightInt] |= leftCvg(right, mask) << shift;
+      } else if(rightInt == leftInt) {
+        cvg[leftInt] |= (rightCvg(left, mask) & leftCvg(right, mask)) << shift;
+      }
+    }
+  }
+}
+
+SpanEval::Buffer SpanEval::evaluate(const RDP::TriParams &params, int32_t y, color_t prim)
+{
+  Buffer buff{};
+  if(y < 0)return buff;
+
+  // same setup as the demo: the scissor only lets a single line through
+  auto triParams = params;
+  auto cmds = RDP::triangleWrite(triParams, RDP::TriAttr::SHADE);
+  uint64_t scissor = RDP::setScissorExtend(0, y, SCREEN_WIDTH, 1);
+
+  EdgeWalker::Clip clip{
+    .xh = (int32_t)((scissor >> 44) & 0xFFF),
+    .yh = (int32_t)((scissor >> 32) & 0xFFF),
+    .xl = (int32_t)((scissor >> 12) & 0xFFF),
+    .yl = (int32_t)(scissor & 0xFFF),
+  };
+
+  auto shade = EdgeWalker::decodeShade(&cmds[4]);
+  std::vector<EdgeWalker::Span> spans(y + 1);
+  auto res = EdgeWalker::walk(cmds.data(), clip, &shade, spans);
+
+  auto &span = spans[y];
+  if(!span.valid || span.rx >= 1024)return buff;
+
+  std::array<uint8_t, 1024> cvgMask{};
+  computeCoverage(span, res.flip, cvgMask);
+
+  // shade starts at the major edge and steps towards the minor one
+  int32_t dir = res.flip ? 1 : -1;
+  int32_t xStart = res.flip ? span.lx : span.rx;
+  int32_t scDiff = (xStart - span.unscrx) * dir;
+  int32_t length = span.rx - span.lx;
+
+  int32_t rgba[4];
+  for(int ch=0; ch<4; ++ch) {
+    rgba[ch] = span.rgba[ch] + shade.dx[ch] * dir * scDiff;
+  }
+
+  const uint32_t primCh[3]{prim.r, prim.g, prim.b};
+  for(int32_t j=0; j<=length; ++j)
+  {
+    int32_t x = xStart + j * dir;
+    uint32_t cvg = __builtin_popcount(cvgMask[x]);
+    if(cvg != 0)
+    {
+      uint32_t col[3];
+      for(int ch=0; ch<3; ++ch) {
+        col[ch] = combine(clamp9Bit(rgba[ch] >> 16), primCh[ch]);
+      }
+      uint32_t cvgBits = cvg - 1;
+      uint32_t packed = ((col[0] >> 3) << 11) | ((col[1] >> 3) << 6) | ((col[2] >> 3) << 1) | (cvgBits >> 2);
+
+      uint32_t px = x % PIXEL_COUNT;
+      uint32_t base = (px / 4) * 4;
+      uint32_t colShift = (px & 1) ? 0 : 16;
+      uint32_t cvgShift = 6 - (px & 3) * 2;
+
+      auto &colWord = buff[base + ((px & 3) >> 1)];
+      colWord = (colWord & ~(0xFFFFu << colShift)) | (packed << colShift);
+      buff[base + 2] = (buff[base + 2] & ~(0b11u << cvgShift)) | ((cvgBits & 0b11) << cvgShift);
+    }
+
+    for(int ch=0; ch<4; ++ch)rgba[ch] += shade.dx[ch] * dir;
+  }
+
+  return buff;
+}
@@ -0,0 +1,36 @@
+/**
+* @copyright 2025 - Max Bebök
+* @license MIT
+*/
+#pragma once
+#include <array>
+#include <cstdint>
+
+#include <libdragon.h>
+#include "rdp/rdp.h"
+
+/**
+ * Predicts the span-buffer contents read back by Demo::RDPTestMode.
+ * A single scanline of a shaded triangle is walked and interpolated with the
+ * same s15.16 coefficients 'RDP::triangleWrite' sends to the hardware.
+ *
+ * Modes are the ones of the demo: 1-cycle, CC = SHADE*PRIM, no dither, AA or blending.
+ * Layout per 4 pixels: [color 0|1, color 2|3, coverage, 0], with colors in RGBA5551.
+ * Coverage is stored as 'cvg-1' (3 bits): the MSB in the alpha bit of the color,
+ * the lower 2 bits in the coverage word (pixel 0 in bits 7..6).
+ * Pixels not touched by the span stay zero, as after 'RDPBuff::clear()'.
+ */
+namespace SpanEval
+{
+  constexpr uint32_t WORD_COUNT = 64;
+  constexpr uint32_t PIXEL_COUNT = WORD_COUNT; // 4 words per 4 pixels
+
+  using Buffer = std::array<uint32_t, WORD_COUNT>;
+
+  /**
+   * Evaluates scanline 'y' of the triangle, the buffer position is 'x % PIXEL_COUNT'.
+   * @param params triangle setup as returned by 'RDP::triangleGen' with shade
+   * @param prim primitive color multiplied with shade
+   */
+  Buffer evaluate(const RDP::TriParams &params, int32_t y, color_t prim);
+}
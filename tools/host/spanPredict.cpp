@@ -0,0 +1,80 @@
+/**
+* @copyright 2025 - Max Bebök
+* @license MIT
+*
+* Prints the span-buffer predicted by spanEval for the triangle of Demo::RDPTestMode,
+* using the same characters as the demo for each pixels coverage.
+*
+* Usage: spanPredict [-x] [width] [height] [primRGB]
+*   width/height  triangle size, defaults to the manual mode of the demo (24, 12)
+*   primRGB       prim. color as hex (default: FFFFFF)
+*   -x            also dump the raw span-buffer words per line
+*/
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "spanEval.h"
+
+namespace
+{
+  constexpr char CVG_CHAR[4] = {'.', '-', '+', '$'};
+  constexpr float TRI_OFFSET[2]{256, 24};
+  constexpr float SIZE = 24;
+}
+
+int main(int argc, char** argv)
+{
+  bool dumpWords = false;
+  std::vector<std::string> args{};
+  for(int i=1; i<argc; ++i) {
+    std::string arg{argv[i]};
+    if(arg == "-x")dumpWords = true;
+    else if(!arg.empty() && arg[0] == '-') {
+      fprintf(stderr, "Usage: %s [-x] [width] [height] [primRGB]\n", argv[0]);
+      return 2;
+    }
+    else args.push_back(arg);
+  }
+
+  float w = args.size() > 0 ? strtof(args[0].c_str(), nullptr) : SIZE;
+  float h = args.size() > 1 ? strtof(args[1].c_str(), nullptr) : SIZE / 2;
+  uint32_t primRGB = args.size() > 2 ? strtoul(args[2].c_str(), nullptr, 16) : 0xFFFFFF;
+  color_t prim{(uint8_t)(primRGB >> 16), (uint8_t)(primRGB >> 8), (uint8_t)primRGB, 0xFF};
+
+  // same vertices as the demo, without the wobble
+  auto triData = RDP::triangleGen(RDP::TriAttr::SHADE, {
+    .pos = {TRI_OFFSET[0], TRI_OFFSET[1]},
+    .color = {0.5f, 1, 1, 0},
+  },{
+    .pos = {TRI_OFFSET[0], TRI_OFFSET[1] + SIZE},
+    .color = {0.25f, 0.4f, 0.2f, 0},
+  },{
+    .pos = {TRI_OFFSET[0] + w, TRI_OFFSET[1] + h},
+    .color = {1, 1, 1, 0},
+  });
+
+  uint32_t startPx = (uint32_t)TRI_OFFSET[0] % SpanEval::PIXEL_COUNT;
+  for(int y=0; y<SIZE; ++y)
+  {
+    auto buff = SpanEval::evaluate(triData, TRI_OFFSET[1] + y, prim);
+
+    printf("%2d: ", y);
+    for(uint32_t px=startPx; px<SpanEval::PIXEL_COUNT; ++px) {
+      uint32_t base = (px / 4) * 4;
+      uint16_t col = buff[base + ((px & 3) >> 1)] >> ((px & 1) ? 0 : 16);
+      uint32_t cvg = (buff[base + 2] >> (6 - (px & 3) * 2)) & 0b11;
+      if(col == 0)break;
+      putchar(CVG_CHAR[cvg]);
+    }
+    putchar('\n');
+
+    if(dumpWords) {
+      for(uint32_t i=0; i<SpanEval::WORD_COUNT; i+=4) {
+        printf("    %08X %08X %02X\n", buff[i], buff[i+1], buff[i+2]);
+      }
+    }
+  }
+  return 0;
+}
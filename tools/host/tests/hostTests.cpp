@@ -0,0 +1,756 @@
+/**
+* @copyright 2025 - Max Bebök
+* @license MIT
+*
+* Checks for the shared sources in src/ built natively against the libdragon shim.
+* Usage: hostTests [name-filter]
+*/
+#include <cstdio>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#include <libdragon.h>
+#include "main.h"
+#include "text.h"
+#include "math.h"
+#include "miMemory.h"
+#include "spanRaster.h"
+#include "taskQueue.h"
+#include "rdpDumpTest.h"
+#include "refPack.h"
+#include "rdp/rdp.h"
+#include "rdp/dpl.h"
+#include "../rdpSim.h"
+#include "../spanEval.h"
+
+State state{};
+
+namespace
+{
+  struct Test {
+    const char* name;
+    std::function<void()> fn;
+  };
+
+  std::vector<Test>& tests() {
+    static std::vector<Test> list{};
+    return list;
+  }
+
+  struct Register {
+    Register(const char* name, std::function<void()> fn) {
+      tests().push_back({name, std::move(fn)});
+    }
+  };
+
+  #include "font.h"
+  #include "font64.h"
+
+  constinit uint32_t failCount = 0;
+
+  #define TEST(name) \
+    void test_##name(); \
+    Register reg_##name{#name, test_##name}; \
+    void test_##name()
+
+  #define CHECK(cond) do { if(!(cond)) { \
+    ++failCount; printf("  FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); } } while(0)
+
+  surface_t fb = surface_make(HostShim::fromPhysical(0x30'0000), FMT_RGBA16, SCREEN_WIDTH, SCREEN_HEIGHT, 0x800);
+
+  uint16_t readPixel(int x, int y) {
+    return ((uint16_t*)fb.buffer)[y * (fb.stride / 2) + x];
+  }
+
+  // -------- Tests -------- //
+
+  TEST(ticks)
+  {
+    // same integer math as libdragon, the round-trip loses a bit
+    uint64_t us = TICKS_TO_US(TICKS_FROM_US(1000));
+    CHECK(us > 970 && us <= 1000);
+    uint64_t start = get_ticks();
+    wait_ms(2);
+    uint64_t elapsed = get_ticks() - start;
+    CHECK(elapsed >= TICKS_FROM_MS(2));
+  }
+
+  TEST(uncachedAlloc)
+  {
+    auto a = (uint8_t*)malloc_uncached(100);
+    auto b = (uint8_t*)malloc_uncached(32);
+    CHECK(a && b);
+    CHECK(PhysicalAddr(a) >= HostShim::HEAP_START);
+    CHECK(((uintptr_t)a & 0xF) == 0);
+    CHECK(b >= a + 100);
+
+    // freed blocks get reused
+    free_uncached(a);
+    auto c = (uint8_t*)malloc_uncached(64);
+    CHECK(c == a);
+    free_uncached(b);
+    free_uncached(c);
+  }
+
+  TEST(dplSubmit)
+  {
+    static uint32_t cmdCount{};
+    HostShim::dpHandler = [](uint32_t start, uint32_t end) {
+      cmdCount = (end - start) / 8;
+    };
+
+    RDP::DPL dpl{8};
+    dpl.add(RDP::syncPipe())
+      .add(RDP::setFillColor({0xFF, 0, 0, 0xFF}))
+      .runSync();
+
+    CHECK(cmdCount == 3); // includes the 'syncFull' added by 'runSync'
+    CHECK(*DP_CURRENT == *DP_END);
+    HostShim::dpHandler = nullptr;
+  }
+
+  TEST(dplRenderSim)
+  {
+    static RDPSim sim{HostShim::rdram, HostShim::RDRAM_SIZE};
+    HostShim::dpHandler = [](uint32_t start, uint32_t end) {
+      sim.run((uint64_t*)(HostShim::rdram + start), (end - start) / 8);
+    };
+
+    RDP::DPL dpl{8};
+    dpl.add(RDP::setColorImage(fb.buffer, RDP::Format::RGBA, RDP::BBP::_16, fb.stride/2))
+      .add(RDP::setScissor(0, 0, fb.width-1, fb.height-1))
+      .add(RDP::setOtherModes(RDP::OtherMode().cycleType(RDP::CYCLE::FILL)))
+      .add(RDP::setFillColor({0xFF, 0xFF, 0xFF, 0xFF}))
+      .add(RDP::fillRect(10, 10, 19, 19))
+      .runSync();
+
+    // white reads the same in both byte orders (the software RDP writes big-endian)
+    CHECK(readPixel(10, 10) == 0xFFFF);
+    CHECK(readPixel(15, 19) == 0xFFFF);
+    CHECK(readPixel(20, 10) != 0xFFFF);
+    HostShim::dpHandler = nullptr;
+  }
+
+  TEST(mathSinBatch)
+  {
+    // (base, step) as used by the per-line effects, plus negative/large values
+    constexpr float SEQUENCES[][2]{{0.03f, 0.03f}, {1.5f, 0.15f}, {-3.7f, 0.45f}, {100.25f, -0.0166f}, {0.0f, 2.5f}};
+    constexpr uint32_t COUNT = 1000;
+    float out[COUNT];
+
+    double maxErr = 0, maxErrApprox = 0;
+    for(auto &seq : SEQUENCES) {
+      Math::sinBatch(out, seq[0], seq[1], COUNT);
+      for(uint32_t i=0; i<COUNT; ++i) {
+        double ref = std::sin((double)seq[0] + (double)seq[1] * i);
+        maxErr = std::fmax(maxErr, std::fabs(out[i] - ref));
+        // sinApprox only reduces the range correctly for x >= -PI
+        float x = seq[0] + seq[1] * i;
+        if(x >= -3.14159f)maxErrApprox = std::fmax(maxErrApprox, std::fabs(Math::sinApprox(x) - ref));
+      }
+    }
+    printf("  max. error: sinBatch %.2e, sinApprox %.2e\n", maxErr, maxErrApprox);
+    CHECK(maxErr < 8e-5);
+
+    Math::sinBatch(out, 1.0f, 0.1f, 0); // no-op
+    Math::sinBatch(out, 0.0f, 0.0f, 4);
+    CHECK(out[0] == 0.0f && out[3] == 0.0f);
+  }
+
+  TEST(taskQueue)
+  {
+    static std::vector<int> order{};
+    static int stepsLeft{};
+    order.clear();
+
+    CHECK(!TaskQueue::runSlice(0)); // empty
+    CHECK(TaskQueue::push([](uint64_t) { order.push_back(1); return true; }));
+    // splits its work, one step per call once the deadline passed
+    CHECK(TaskQueue::push([](uint64_t deadline) {
+      do { order.push_back(2); } while(--stepsLeft > 0 && get_ticks() < deadline);
+      return stepsLeft <= 0;
+    }));
+    CHECK(TaskQueue::push([](uint64_t) { order.push_back(3); return true; }));
+    stepsLeft = 3;
+
+    // a zero budget still makes progress, one call per slice
+    CHECK(TaskQueue::runSlice(0));
+    CHECK(order.size() == 1 && TaskQueue::pending() == 2);
+    CHECK(TaskQueue::runSlice(0));
+    CHECK(order.size() == 2 && TaskQueue::pending() == 2);
+
+    TaskQueue::flush();
+    CHECK(TaskQueue::pending() == 0);
+    CHECK((order == std::vector<int>{1, 2, 2, 2, 3}));
+
+    for(uint32_t i=0; i<TaskQueue::MAX_TASKS; ++i) {
+      CHECK(TaskQueue::push([](uint64_t) { order.push_back(4); return true; }));
+    }
+    CHECK(!TaskQueue::push([](uint64_t) { return true; }));
+    CHECK(!TaskQueue::runSlice(TICKS_FROM_MS(100)));
+    CHECK(order.size() == 5 + TaskQueue::MAX_TASKS);
+  }
+
+  TEST(miRepeat)
+  {
+    auto buff = (uint64_t*)HostShim::fromPhysical(0x30'0000);
+    memset(buff, 0xEE, 512);
+
+    MiMem::writeAligned(buff, 0x1122334455667788, 200);
+    CHECK(buff[0] == 0x1122334455667788);
+    CHECK(buff[199/8] == 0x1122334455667788);
+    CHECK(buff[200/8] != 0x1122334455667788);
+    CHECK(*MI_MODE == 0);
+
+    // unaligned starts only touch bytes up to the next 8-byte boundary first
+    memset(buff, 0xEE, 512);
+    MiMem::write((uint8_t*)buff + 4, 0, 20);
+    CHECK(((uint8_t*)buff)[3] == 0xEE);
+    CHECK(((uint8_t*)buff)[4] == 0);
+    CHECK(((uint8_t*)buff)[23] == 0);
+
+    CHECK(MiMem::isSupported());
+  }
+
+  TEST(miRepeatSizes)
+  {
+    struct Trace { uint32_t writes, maxLen; bool wrapped; };
+    static Trace trace{};
+    HostShim::miRepeatHandler = [](uint32_t addr, uint32_t len) {
+      ++trace.writes;
+      if(len > trace.maxLen)trace.maxLen = len;
+      trace.wrapped |= (addr & 0x7FF) + len > 0x800;
+    };
+
+    // every size/alignment against memset, inside a single 0x800 block with guard bytes around it
+    constexpr uint32_t BASE = 0x30'0100;
+    constexpr uint32_t GUARD = 16;
+    auto buff = (uint8_t*)HostShim::fromPhysical(BASE);
+    uint8_t expected[512 + 2*GUARD];
+
+    auto check = [&](uint32_t align, uint32_t size, uint8_t value, auto &&fill) {
+      memset(buff - GUARD, 0xEE, sizeof(expected));
+      memset(expected, 0xEE, sizeof(expected));
+      memset(expected + GUARD + align, value, size);
+      trace = {};
+      fill(buff + align);
+
+      uint32_t repeatsNeeded = (size + (align & 0b111) + 127) / 128;
+      bool ok = memcmp(buff - GUARD, expected, sizeof(expected)) == 0
+        && trace.maxLen <= 128 && !trace.wrapped && trace.writes <= repeatsNeeded + 1
+        && *MI_MODE == 0;
+      if(!ok)printf("  size %u, align %u, value %02X (%u writes)\n", size, align, value, trace.writes);
+      return ok;
+    };
+
+    uint32_t errors = 0;
+    for(uint32_t size=1; size<=400; ++size) {
+      errors += !check(0, size, 0x5A, [&](uint8_t *dst) {
+        MiMem::writeAligned((uint64_t*)dst, 0x5A5A'5A5A'5A5A'5A5A, size);
+      });
+      for(uint32_t align=0; align<8; ++align) {
+        errors += !check(align, size, 0, [&](uint8_t *dst) {
+          MiMem::zeroUnaligned((char*)dst, size);
+        });
+        // the 'sdl' of unaligned starts always stores up to the next 8-byte boundary
+        if(size >= 8 - align) {
+          errors += !check(align, size, 0xA5, [&](uint8_t *dst) {
+            MiMem::write(dst, 0xA5A5'A5A5'A5A5'A5A5, size);
+          });
+        }
+      }
+    }
+    CHECK(errors == 0);
+
+    // repeat-mode is cleared by the first write, so each 128-byte step has to set it again
+    memset(buff, 0xEE, 32);
+    *MI_MODE = MI_WMODE_SET_REPEAT | 15;
+    uint64_t value = 0;
+    HostShim::miWrite(buff, &value, 8);
+    HostShim::miWrite(buff + 16, &value, 8);
+    CHECK(buff[15] == 0 && buff[23] == 0 && buff[24] == 0xEE);
+
+    HostShim::miRepeatHandler = nullptr;
+  }
+
+  TEST(miFillRect)
+  {
+    // odd stride, so rows cross 0x800 boundaries
+    surface_t surf = surface_make(HostShim::fromPhysical(0x30'0000), FMT_RGBA16, 300, 40, 0x260);
+    constexpr int RECTS[][4]{{0, 0, 300, 40}, {3, 1, 250, 7}, {-5, 30, 20, 20}, {290, 2, 3, 5}, {101, 10, 7, 3}};
+
+    for(auto &rect : RECTS) {
+      memset(surf.buffer, 0xEE, surf.stride * (surf.height + 1));
+      MiMem::fillRect(surf, rect[0], rect[1], rect[2], rect[3], 0x1234);
+
+      uint32_t errors = 0;
+      auto bytes = (uint8_t*)surf.buffer;
+      for(int y=0; y<=surf.height; ++y) {
+        for(int x=0; x<surf.stride/2; ++x) {
+          bool inside = x >= rect[0] && x < rect[0] + rect[2] && x < surf.width
+                     && y >= rect[1] && y < rect[1] + rect[3] && y < surf.height;
+          uint16_t px;
+          memcpy(&px, bytes + y * surf.stride + x * 2, 2);
+          errors += px != (inside ? 0x1234 : 0xEEEE);
+        }
+      }
+      CHECK(errors == 0);
+    }
+    CHECK(*MI_MODE == 0);
+  }
+
+  TEST(spanRaster)
+  {
+    // odd stride, so rows cross 0x800 boundaries
+    surface_t surf = surface_make(HostShim::fromPhysical(0x30'0000), FMT_RGBA16, 300, 60, 0x260);
+    const std::vector<std::vector<SpanRaster::Point>> SHAPES{
+      {{10.3f, 5.7f}, {280.6f, 12.2f}, {150.1f, 50.9f}},                   // clockwise
+      {{150.1f, 50.9f}, {280.6f, 12.2f}, {10.3f, 5.7f}},                   // counter-clockwise
+      {{-20.4f, -10.2f}, {340.7f, 20.3f}, {120.2f, 80.6f}, {-30.1f, 40.8f}}, // clipped on all sides
+      {{100.2f, 20.3f}, {110.7f, 20.3f}, {115.4f, 30.6f}, {105.3f, 38.1f}, {96.6f, 30.4f}},
+      {{50.5f, 10.5f}, {60.5f, 10.5f}, {55.5f, 10.5f}},                     // zero area
+    };
+
+    for(auto &shape : SHAPES) {
+      memset(surf.buffer, 0xEE, surf.stride * (surf.height + 1));
+      SpanRaster::fillConvex(surf, shape.data(), shape.size(), 0x1234);
+
+      // reference: pixel centers inside all edges (with the winding of the shape)
+      float area = 0;
+      for(size_t i=0; i<shape.size(); ++i) {
+        auto &a = shape[i], &b = shape[(i+1) % shape.size()];
+        area += a.x * b.y - b.x * a.y;
+      }
+
+      uint32_t errors = 0;
+      auto bytes = (uint8_t*)surf.buffer;
+      for(int y=0; y<=surf.height; ++y) {
+        for(int x=0; x<surf.stride/2; ++x) {
+          bool inside = area != 0 && x < surf.width && y < surf.height;
+          for(size_t i=0; i<shape.size() && inside; ++i) {
+            auto &a = shape[i], &b = shape[(i+1) % shape.size()];
+            float side = (b.x - a.x) * (y + 0.5f - a.y) - (b.y - a.y) * (x + 0.5f - a.x);
+            inside = area > 0 ? side > 0 : side < 0;
+          }
+          uint16_t px;
+          memcpy(&px, bytes + y * surf.stride + x * 2, 2);
+          errors += px != (inside ? 0x1234 : 0xEEEE);
+        }
+      }
+      CHECK(errors == 0);
+    }
+    CHECK(*MI_MODE == 0);
+  }
+
+  TEST(spanEvalLayout)
+  {
+    // white, flat-shaded triangle whose left edge sits on buffer pixel 0 (x=64), same modes as RDPTestMode
+    auto triData = RDP::triangleGen(RDP::TriAttr::SHADE,
+      {.pos = {64, 0},  .color = {1, 1, 1, 1}},
+      {.pos = {64, 32}, .color = {1, 1, 1, 1}},
+      {.pos = {80, 16}, .color = {1, 1, 1, 1}}
+    );
+    auto buff = SpanEval::evaluate(triData, 16, {0xFF, 0xFF, 0xFF, 0xFF});
+
+    // pixels 0-3 fully covered: RGBA5551 white with the coverage MSB as alpha, cvg-1 = 0b11 per pixel
+    CHECK(buff[0] == 0xFFFF'FFFF);
+    CHECK(buff[1] == 0xFFFF'FFFF);
+    CHECK(buff[2] == 0xFF);
+    CHECK(((buff[2] >> 6) & 0b11) == 0b11); // pixel 0
+    CHECK(buff[3] == 0);
+
+    // untouched pixels (right of the span) stay cleared
+    CHECK(buff[SpanEval::WORD_COUNT-4] == 0);
+    CHECK(buff[SpanEval::WORD_COUNT-2] == 0);
+  }
+
+  TEST(textPrint)
+  {
+    state.fb = &fb;
+    memset(fb.buffer, 0, fb.stride * fb.height);
+
+    Text::setColor({0xFF, 0xFF, 0xFF, 0xFF});
+    int x = Text::print(16, 16, "A");
+    CHECK(x == 17);
+
+    uint32_t setPixels = 0;
+    for(int y=16; y<24; ++y) {
+      for(int x=16; x<24; ++x)setPixels += readPixel(x, y) != 0;
+    }
+    CHECK(setPixels > 8);
+    CHECK(readPixel(30, 16) == 0);
+  }
+
+  TEST(textGlyphs)
+  {
+    state.fb = &fb;
+    const uint64_t *words = (const uint64_t*)fb.buffer;
+    constexpr color_t COLORS[]{{0xFF, 0xFF, 0xFF, 0xFF}, {0x12, 0x34, 0x56, 0}, {0xFF, 0, 0, 0xFF}};
+
+    for(auto color : COLORS)
+    {
+      memset(fb.buffer, 0xAA, fb.stride * fb.height);
+      Text::setColor(color);
+      char str[2]{};
+      for(int c=0; c<95; ++c) {
+        str[0] = (char)(' ' + c);
+        Text::print((c % 32) * 8, (c / 32) * 10, str);
+      }
+
+      // each row-nibble expanded with the pixel of bit 0 in the upper 16 bits
+      uint64_t col = color_to_packed16(color);
+      uint32_t errors = 0;
+      for(int c=1; c<95; ++c) {
+        uint64_t data = FONT_8x8_DATA[c];
+        const uint64_t *glyph = words + (c / 32) * 10 * (fb.stride / 8) + (c % 32) * 2;
+        for(int i=0; i<16; ++i, data >>= 4) {
+          uint64_t expected = ((data & 1) ? (col << 48) : 0) | ((data & 2) ? (col << 32) : 0)
+                            | ((data & 4) ? (col << 16) : 0) | ((data & 8) ? col : 0);
+          errors += glyph[(i / 2) * (fb.stride / 8) + (i & 1)] != expected;
+        }
+      }
+      CHECK(errors == 0);
+    }
+    Text::setColor();
+  }
+
+  TEST(textFormat)
+  {
+    char buff[64], ref[64];
+    uint32_t errors = 0;
+    auto compare = [&](int len) {
+      if(strcmp(buff, ref) != 0 || len != (int)strlen(ref)) {
+        ++errors;
+        printf("  '%s' != '%s'\n", buff, ref);
+      }
+    };
+
+    for(int32_t v : {0, 7, -7, 42, -1234, 99999, INT32_MIN, INT32_MAX}) {
+      snprintf(ref, sizeof(ref), "[%d|%5d|%-5d|%05d]", v, v, v, v);
+      compare(Text::format(buff, sizeof(buff), "[%d|%5d|%-5d|%05d]", v, v, v, v));
+      snprintf(ref, sizeof(ref), "%X %x %08X %03X", v, v, v, v & 0xFFF);
+      compare(Text::format(buff, sizeof(buff), "%X %x %08X %03X", v, v, v, v & 0xFFF));
+    }
+    for(uint64_t v : {0ull, 255ull, 0xFFFF'FFFF'FFFF'FFFFull}) {
+      snprintf(ref, sizeof(ref), "%llu %llX", (unsigned long long)v, (unsigned long long)v);
+      compare(Text::format(buff, sizeof(buff), "%u %X", v, v));
+    }
+    for(float v : {0.0f, 0.004f, 0.005f, 1.0f, 16.625f, 16.6667f, -3.25f, 1234.5f}) {
+      snprintf(ref, sizeof(ref), "%.2fms|%6.1f|%7.0f|%f|%-8.3f|%08.2f", v, v, v, v, v, v);
+      compare(Text::format(buff, sizeof(buff), "%.2fms|%6.1f|%7.0f|%f|%-8.3f|%08.2f", v, v, v, v, v, v));
+    }
+    // largest values that still fit the 64-bit fixed-point at a high precision
+    for(float v : {1.7e10f, -1.7e10f}) {
+      snprintf(ref, sizeof(ref), "%.9f", v);
+      compare(Text::format(buff, sizeof(buff), "%.9f", v));
+    }
+    snprintf(ref, sizeof(ref), "%.5f", 1e14f);
+    compare(Text::format(buff, sizeof(buff), "%.5f", 1e14f));
+    // above that the value is clamped
+    snprintf(ref, sizeof(ref), "18000000000.000000000|-18000000000.000000000|%.0f", 1e15f);
+    compare(Text::format(buff, sizeof(buff), "%.9f|%.9f|%.0f", 1e12f, -1e12f, 1e16f));
+
+    snprintf(ref, sizeof(ref), "%-16s|%4s|%c|100%%", "name", "ok", 'x');
+    compare(Text::format(buff, sizeof(buff), "%-16s|%4s|%c|100%%", "name", "ok", 'x'));
+    CHECK(errors == 0);
+
+    // output is cut off, but always terminated
+    int len = Text::format(buff, 6, "%d", 123456789);
+    CHECK(len == 5 && strcmp(buff, "12345") == 0);
+  }
+
+  TEST(textLayer)
+  {
+    surface_t fbs[3]{fb,
+      surface_make(HostShim::fromPhysical(0x38'0000), FMT_RGBA16, SCREEN_WIDTH, SCREEN_HEIGHT, 0x800),
+      surface_make(HostShim::fromPhysical(0x40'0000), FMT_RGBA16, SCREEN_WIDTH, SCREEN_HEIGHT, 0x800),
+    };
+    for(auto &surf : fbs)memset(surf.buffer, 0, surf.stride * surf.height);
+    Text::Layer::removeAll();
+
+    auto handle = Text::Layer::create();
+    Text::Layer::print(handle, 16, 16, "12.34ms");
+
+    // each buffer gets the string once
+    for(int i=0; i<6; ++i) {
+      state.fb = &fbs[i % 3];
+      CHECK(Text::Layer::draw() == (i < 3 ? 1u : 0u));
+    }
+
+    // same as a direct print
+    state.fb = &fbs[0];
+    std::vector<uint8_t> layerFB((uint8_t*)fb.buffer, (uint8_t*)fb.buffer + fb.stride * fb.height);
+    memset(fb.buffer, 0, fb.stride * fb.height);
+    Text::print(16, 16, "12.34ms");
+    CHECK(memcmp(layerFB.data(), fb.buffer, layerFB.size()) == 0);
+
+    // shorter strings clear what was left over
+    Text::Layer::print(handle, 16, 16, "9.1ms");
+    CHECK(Text::Layer::draw() == 1);
+    memset(fb.buffer, 0, fb.stride * fb.height);
+    Text::print(16, 16, "9.1ms");
+    memcpy(layerFB.data(), fb.buffer, layerFB.size());
+    state.fb = &fbs[1];
+    CHECK(Text::Layer::draw() == 1);
+    CHECK(memcmp(layerFB.data(), fbs[1].buffer, layerFB.size()) == 0);
+
+    // moving and removing leaves nothing behind
+    Text::Layer::print(handle, 64, 32, "X");
+    Text::Layer::draw();
+    Text::Layer::remove(handle);
+    Text::Layer::draw();
+    uint32_t setBytes = 0;
+    for(uint32_t i=0; i<layerFB.size(); ++i)setBytes += ((uint8_t*)fbs[1].buffer)[i] != 0;
+    CHECK(setBytes == 0);
+
+    // cleared buffers need a full redraw
+    handle = Text::Layer::create();
+    Text::Layer::print(handle, 16, 16, "A");
+    CHECK(Text::Layer::draw() == 1);
+    CHECK(Text::Layer::draw() == 0);
+    Text::Layer::invalidate();
+    CHECK(Text::Layer::draw() == 1);
+
+    // bands only take strings starting in them, a moved one goes with the first row it touches
+    auto handleLow = Text::Layer::create();
+    Text::Layer::print(handleLow, 16, 100, "B");
+    Text::Layer::print(handle, 16, 20, "C");
+    CHECK(Text::Layer::draw(0, 16) == 0);
+    CHECK(Text::Layer::draw(16, 32) == 1);
+    CHECK(Text::Layer::draw(96, 112) == 1);
+    Text::Layer::print(handleLow, 16, 8, "B");
+    CHECK(Text::Layer::draw(96, 112) == 0);
+    CHECK(Text::Layer::draw(0, 16) == 1);
+    Text::Layer::print(handle, 16, 200, "C");
+    CHECK(Text::Layer::draw(192, 208) == 0);
+    CHECK(Text::Layer::draw(16, 32) == 1);
+    CHECK(Text::Layer::draw() == 0);
+    Text::Layer::removeAll();
+  }
+
+  TEST(textBatch)
+  {
+    state.fb = &fb;
+    Text::setColor();
+    RDP::DPL dpl{64};
+    Text::Batch::begin(dpl);
+    CHECK(dpl.dplEnd - dpl.dpl == Text::Batch::SETUP_CMDS);
+
+    // font atlas in RDRAM, I4 with 2 glyphs per 8-byte row and 9 rows per glyph
+    const uint8_t *atlas = nullptr;
+    for(auto cmd = dpl.dpl; cmd != dpl.dplEnd; ++cmd) {
+      if((*cmd >> 56) == 0x3D)atlas = (const uint8_t*)HostShim::fromPhysical(*cmd & 0x3FF'FFFF);
+    }
+    CHECK(atlas != nullptr);
+    if(!atlas)return;
+
+    uint32_t errors = 0;
+    for(int c=0; c<95; ++c) {
+      for(int y=0; y<9; ++y) {
+        for(int x=0; x<8; ++x) {
+          uint8_t texel = atlas[((c / 2) * 9 + y) * 8 + (c % 2) * 4 + x / 2];
+          texel = (x & 1) ? (texel & 0xF) : (texel >> 4);
+          bool isSet = y < 8 && ((FONT_8x8_DATA[c] >> (y * 8 + x)) & 1);
+          errors += texel != (isSet ? 0xF : 0);
+        }
+      }
+    }
+    CHECK(errors == 0);
+
+    // 'B' (glyph 34) is the left one of row 17, spaces are skipped
+    dpl.reset();
+    int x = Text::Batch::print(dpl, 16, 40, "A B");
+    CHECK(x == 19);
+    CHECK(dpl.dplEnd - dpl.dpl == 2 * Text::Batch::GLYPH_CMDS);
+    auto rect = RDP::textureRect(0, 32, 40, 40, 49, 0, 17 * 9);
+    CHECK(dpl.dpl[2] == rect[0] && dpl.dpl[3] == rect[1]);
+
+    // only color changes add a prim-color
+    dpl.reset();
+    Text::setColor({0xFF, 0, 0, 0xFF});
+    Text::Batch::print(dpl, 16, 40, "A");
+    Text::Batch::print(dpl, 24, 40, "A");
+    CHECK(dpl.dplEnd - dpl.dpl == Text::Batch::COLOR_CMDS + 2 * Text::Batch::GLYPH_CMDS);
+    CHECK(dpl.dpl[1] == RDP::setPrimColor(0xFF00'00FF));
+    Text::setColor();
+  }
+
+  TEST(textLarge)
+  {
+    state.fb = &fb;
+    constexpr const char* STR = "{MI-Repeat}";
+    constexpr int POS[][2]{{16, 68}, {-50, 10}, {250, 200}, {-10, -30}};
+
+    // black uses byte-sized repeat writes (MiMem::zeroUnaligned)
+    for(uint64_t color : {0x1234'1234'1234'1234ull, 0xF00F'F00F'F00F'F00Full, 0ull}) {
+      for(auto pos : POS) {
+        memset(fb.buffer, 0xAA, fb.stride * fb.height);
+        Text::printLarge(pos[0], pos[1], STR, {.color = color, .posCB = [](int &x, int &y, int idx) {
+          y += (idx & 1) * 5;
+        }});
+
+        // reference: plain per-pixel decode of each glyph, clipped to the screen
+        std::vector<uint16_t> expected(fb.width * fb.height, 0xAAAA);
+        int x = pos[0], y = pos[1];
+        for(int c=0; STR[c]; ++c, x += 40) {
+          y += (c & 1) * 5; // same as the callback, which moves the position for all following glyphs
+          const uint8_t *data = &FONT_64_DATA[FONT_64_IDX[STR[c] - ' ']];
+          for(int row=0; row<64; ++row) {
+            int px = 0;
+            for(bool isSolid = false; px < 64; isSolid = !isSolid) {
+              uint8_t size = *(data++);
+              for(int s=0; isSolid && s<size; ++s) {
+                int sx = x + px + s, sy = y + row;
+                if(sx >= 0 && sx < fb.width && sy >= 0 && sy < fb.height)expected[sy * fb.width + sx] = (uint16_t)color;
+              }
+              px += size;
+            }
+          }
+        }
+
+        uint32_t errors = 0;
+        for(int y=0; y<fb.height; ++y) {
+          for(int x=0; x<fb.width; ++x)errors += readPixel(x, y) != expected[y * fb.width + x];
+        }
+        CHECK(errors == 0);
+      }
+    }
+
+    // more visible glyphs than fit into one batch, placed in 3 rows of 8 by the callback
+    constexpr const char* STR_GRID = "ABCDEFGHIJKLMNOPQRSTUVWX";
+    constexpr uint64_t COLOR_GRID = 0x4321'4321'4321'4321ull;
+    memset(fb.buffer, 0xAA, fb.stride * fb.height);
+    Text::printLarge(0, 0, STR_GRID, {.color = COLOR_GRID, .posCB = [](int &x, int &y, int idx) {
+      x = (idx % 8) * 38;
+      y = (idx / 8) * 70;
+    }});
+
+    std::vector<uint16_t> expected(fb.width * fb.height, 0xAAAA);
+    for(int c=0; STR_GRID[c]; ++c) {
+      int x = (c % 8) * 38, y = (c / 8) * 70;
+      const uint8_t *data = &FONT_64_DATA[FONT_64_IDX[STR_GRID[c] - ' ']];
+      for(int row=0; row<64; ++row) {
+        int px = 0;
+        for(bool isSolid = false; px < 64; isSolid = !isSolid) {
+          uint8_t size = *(data++);
+          for(int s=0; isSolid && s<size; ++s) {
+            int sx = x + px + s, sy = y + row;
+            if(sx >= 0 && sx < fb.width && sy >= 0 && sy < fb.height)expected[sy * fb.width + sx] = (uint16_t)COLOR_GRID;
+          }
+          px += size;
+        }
+      }
+    }
+
+    uint32_t errors = 0;
+    for(int y=0; y<fb.height; ++y) {
+      for(int x=0; x<fb.width; ++x)errors += readPixel(x, y) != expected[y * fb.width + x];
+    }
+    CHECK(errors == 0);
+  }
+
+  TEST(refPack)
+  {
+    // same layout as tools/packTests.mjs, in host byte-order
+    struct { uint32_t magic; uint16_t version, entryCount; uint32_t pixelCount, reserved; } header{0x52363454, 1, 2, 5, 0};
+    const uint16_t DATA_A[]{0x8004, 0x1234};              // run of 5
+    const uint16_t DATA_B[]{0x0001, 0x1111, 0x2222, 0x8002}; // 2 literals, run header without its value
+    RefPack::Entry entries[2]{
+      {0x10, sizeof(header) + sizeof(entries), sizeof(DATA_A)},
+      {0x20, sizeof(header) + sizeof(entries) + sizeof(DATA_A), sizeof(DATA_B)},
+    };
+
+    constexpr const char* PATH = "refPackTest.pack";
+    auto writePack = [&](uint32_t tableBytes, uint32_t sizeB) {
+      entries[1].size = sizeB;
+      FILE *f = fopen(PATH, "wb");
+      fwrite(&header, sizeof(header), 1, f);
+      fwrite(entries, 1, tableBytes, f);
+      if(tableBytes == sizeof(entries)) {
+        fwrite(DATA_A, sizeof(DATA_A), 1, f);
+        fwrite(DATA_B, sizeof(DATA_B), 1, f);
+      }
+      fclose(f);
+    };
+
+    // entry B is cut short, the reader must stop at its end
+    writePack(sizeof(entries), sizeof(DATA_B));
+    CHECK(RefPack::open(PATH));
+    CHECK(RefPack::getPixelCount() == 5);
+    CHECK(RefPack::find(0x15) == nullptr);
+
+    auto entryB = RefPack::find(0x20);
+    CHECK(entryB != nullptr);
+    if(entryB) {
+      uint16_t *data = RefPack::load(*entryB);
+      CHECK(data != nullptr);
+      RefPack::Reader reader{data, data + entryB->size / 2};
+      uint16_t pixels[5];
+      for(auto &px : pixels)px = reader.next();
+      CHECK(pixels[0] == 0x1111 && pixels[1] == 0x2222 && pixels[2] == 0 && pixels[4] == 0);
+      CHECK(reader.data == data + entryB->size / 2);
+      free(data);
+    }
+
+    // truncated entry table, data past the end of the file, missing file
+    writePack(sizeof(entries) - 4, sizeof(DATA_B));
+    CHECK(!RefPack::open(PATH));
+    writePack(sizeof(entries), sizeof(DATA_B) + 2);
+    CHECK(!RefPack::open(PATH));
+    CHECK(RefPack::find(0x10) == nullptr);
+    CHECK(!RefPack::open("missing.pack"));
+
+    remove(PATH);
+  }
+
+  TEST(dumpTestNoRef)
+  {
+    state.fb = &fb;
+    RDPDumpTest test{};
+    test.testCases = {0x1234, 0x5678};
+    test.testRegion = {16, 48, 32, 50};
+    test.reset();
+
+    // missing references dump the region, captured instead of flooding the output
+    FILE* log = tmpfile();
+    HostShim::debugOut = log;
+    uint32_t calls = 0;
+    test.run([&](uint32_t) { ++calls; });
+    test.run([&](uint32_t) { ++calls; });
+    HostShim::debugOut = stderr;
+
+    char logText[4096]{};
+    rewind(log);
+    fread(logText, 1, sizeof(logText)-1, log);
+    fclose(log);
+
+    auto stats = test.getStats();
+    CHECK(calls == 2);
+    CHECK(stats.done == 2);
+    CHECK(stats.noRef == 2);
+    CHECK(test.isFinished());
+    CHECK(strstr(logText, "TEST=00001234\n"));
+    CHECK(strstr(logText, "TEST=00005678\n"));
+  }
+}
+
+int main(int argc, char** argv)
+{
+  const char* filter = argc > 1 ? argv[1] : nullptr;
+
+  uint32_t runCount = 0;
+  for(auto &test : tests())
+  {
+    if(filter && !strstr(test.name, filter))continue;
+    uint32_t failsBefore = failCount;
+    test.fn();
+    ++runCount;
+    printf("%-16s %s\n", test.name, failCount == failsBefore ? "OK" : "FAIL");
+  }
+
+  printf("\n%u tests, %u failed checks\n", runCount, failCount);
+  return failCount ? 1 : 0;
+}
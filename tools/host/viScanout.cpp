@@ -0,0 +1,311 @@
+/**
+* @copyright 2025 - Max Bebök
+* @license MIT
+*
+* Runs the per-line VI effects of Demo::VI / Demo::VIPong natively and simulates the VI scan-out
+* of their register schedule (VI_X_SCALE / VI_H_VIDEO per line) into PNGs.
+* The framebuffer is drawn by the demo itself, through the software RDP (fill-mode only, no text).
+* Also estimates the VR4300 cycles spent building the schedule per line, against the budget of an NTSC line.
+* The work is measured on the host, without the software RDP, and scaled by a fixed factor:
+* host instructions (perf counters) if available, otherwise host time.
+*
+* Usage: viScanout [-d vi|pong] [-b] [-n frames] [-o prefix] [-f factor]
+*   -d  demo to run (default: vi)
+*   -b  beam-racing, the frame is drawn in bands via 'drawBand' (only pong)
+*   -n  frames to simulate (default: 1), each one 0.025s of demo time apart
+*   -o  output prefix, writes <prefix>.png or <prefix>_000.png... (default: viScanout)
+*   -f  VR4300 cycles per host instruction (or per host ns without perf counters)
+*/
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <libdragon.h>
+#include "main.h"
+#include "viTimeline.h"
+#include "taskQueue.h"
+#include "rdpSim.h"
+#include "png.h"
+
+State state{};
+
+namespace Demo::VI {
+  extern const char* const name;
+  void init(); void draw(); void destroy();
+}
+namespace Demo::VIPong {
+  extern const char* const name;
+  void init(); void draw(); void destroy();
+  void drawBand(uint32_t y0, uint32_t y1);
+}
+
+namespace
+{
+  // libdragon's NTSC 320x240 setup, 'V_START' matches the mapping of the demos (36 + y*2)
+  constexpr uint32_t DEFAULT_X_SCALE = 0x200;
+  constexpr uint32_t DEFAULT_H_VIDEO = (108 << 16) | 748;
+  constexpr uint32_t V_START = 36;
+
+  constexpr uint32_t OUT_WIDTH = 800; // covers the whole H_VIDEO range of a line
+
+  // VR4300 at 93.75MHz, one NTSC line takes 63.556us
+  constexpr double LINE_CYCLES = 93.75 * 63.556;
+
+  /**
+   * Rough host to VR4300 factors, override with '-f' once calibrated against the console.
+   * Per instruction: MIPS needs a few more instructions than x86-64 for the same code (no memory operands,
+   * split immediates), and the in-order VR4300 averages above 1 cycle each (interlocks, cache misses).
+   * Per ns: a ~3.5GHz out-of-order host core retires about 100-150x the instructions of the VR4300.
+   */
+  constexpr double CYCLES_PER_HOST_INSTR = 1.5;
+  constexpr double CYCLES_PER_HOST_NS = 12.0;
+
+  struct Write {
+    volatile uint32_t *reg;
+    uint32_t value;
+    uint32_t line;
+  };
+
+  /**
+   * Host cost of the schedule building, between 'begin' and 'submit'.
+   * Paused while the software RDP runs, which the console does in hardware.
+   */
+  struct BuildMeter
+  {
+    int perfFd{-1}; // user-space instructions, -1 if perf counters are not available
+    bool active{};
+    std::chrono::steady_clock::time_point start{};
+    double ns{};
+
+    void init() {
+      perf_event_attr attr{};
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.size = sizeof(attr);
+      attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+      attr.disabled = 1;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      perfFd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+
+    void begin() {
+      ns = 0;
+      active = true;
+      if(perfFd >= 0)ioctl(perfFd, PERF_EVENT_IOC_RESET, 0);
+      resume();
+    }
+    void pause() {
+      ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+      if(perfFd >= 0)ioctl(perfFd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+    void resume() {
+      if(perfFd >= 0)ioctl(perfFd, PERF_EVENT_IOC_ENABLE, 0);
+      start = std::chrono::steady_clock::now();
+    }
+    void end() {
+      pause();
+      active = false;
+    }
+
+    // host units of the last build: instructions, or ns without perf counters
+    double units() const {
+      uint64_t instr = 0;
+      if(perfFd >= 0 && read(perfFd, &instr, sizeof(instr)) == sizeof(instr))return (double)instr;
+      return ns;
+    }
+  };
+
+  // schedule of the last submitted frame, and the host work spent building it
+  std::vector<Write> building{};
+  std::vector<Write> schedule{};
+  BuildMeter meter{};
+  double buildUnits{};
+  double buildNs{};
+
+  surface_t fb = surface_make(HostShim::fromPhysical(0x30'0000), FMT_RGBA16, SCREEN_WIDTH, SCREEN_HEIGHT, 0x800);
+
+  // the software RDP writes big-endian, CPU-drawn pixels (e.g. 'Text::Layer') come out with swapped colors
+  uint16_t readPixel(uint32_t x, uint32_t y) {
+    auto px = (uint8_t*)fb.buffer + y * fb.stride + x * 2;
+    return (px[0] << 8) | px[1];
+  }
+
+  /**
+   * Nearest-neighbor model of a progressive scan-out: each output line uses the registers
+   * written up to its half-line, H_VIDEO gives the visible range and X_SCALE (2.10) the source step.
+   */
+  std::vector<uint32_t> scanOut()
+  {
+    std::vector<uint32_t> out(OUT_WIDTH * SCREEN_HEIGHT * 2, 0x000000FF);
+    uint32_t xScale = DEFAULT_X_SCALE;
+    uint32_t hVideo = DEFAULT_H_VIDEO;
+    size_t nextWrite = 0;
+
+    for(uint32_t y=0; y<SCREEN_HEIGHT; ++y)
+    {
+      uint32_t halfLine = V_START + y*2;
+      for(; nextWrite < schedule.size() && schedule[nextWrite].line <= halfLine; ++nextWrite) {
+        auto &write = schedule[nextWrite];
+        if(write.reg == VI_X_SCALE)xScale = write.value;
+        if(write.reg == VI_H_VIDEO)hVideo = write.value;
+      }
+
+      uint32_t start = (hVideo >> 16) & 0x3FF;
+      uint32_t end = hVideo & 0x3FF;
+      uint32_t scale = xScale & 0xFFF;
+      uint32_t offset = (xScale >> 16) & 0xFFF;
+      if(end > OUT_WIDTH)end = OUT_WIDTH;
+
+      for(uint32_t x=start; x<end; ++x) {
+        uint32_t srcX = (offset + (x - start) * scale) >> 10;
+        if(srcX >= fb.stride / 2u)break; // the VI keeps reading into the stride padding, but not past the row
+        uint32_t col = PNG::rgba16ToRGBA32(readPixel(srcX, y)) | 0xFF;
+        out[(y*2) * OUT_WIDTH + x] = col;
+        out[(y*2+1) * OUT_WIDTH + x] = col;
+      }
+    }
+    return out;
+  }
+
+  void writePNG(const std::string &path, const std::vector<uint32_t> &rgba)
+  {
+    std::vector<uint8_t> bytes(rgba.size() * 4);
+    for(size_t i=0; i<rgba.size(); ++i) {
+      bytes[i*4+0] = rgba[i] >> 24;
+      bytes[i*4+1] = rgba[i] >> 16;
+      bytes[i*4+2] = rgba[i] >> 8;
+      bytes[i*4+3] = rgba[i];
+    }
+    if(!PNG::write(path, bytes.data(), OUT_WIDTH, SCREEN_HEIGHT * 2)) {
+      fprintf(stderr, "Failed to write %s\n", path.c_str());
+    }
+  }
+}
+
+// records the schedule instead of running it from interrupts
+void VITimeline::init(void(*)()) {}
+void VITimeline::begin() {
+  building.clear();
+  meter.begin();
+}
+void VITimeline::add(uint32_t line, volatile uint32_t *reg, uint32_t value) {
+  building.push_back({reg, value, line});
+}
+void VITimeline::submit() {
+  meter.end();
+  buildNs = meter.ns;
+  buildUnits = meter.units();
+  schedule = building;
+}
+void VITimeline::stop() { schedule.clear(); }
+void VITimeline::beginLive() {}
+void VITimeline::addLive(uint32_t line, volatile uint32_t *reg, uint32_t value) {
+  building.push_back({reg, value, line});
+}
+void VITimeline::armProbe(uint32_t, volatile uint32_t*, uint32_t) {}
+uint64_t VITimeline::getProbeTicks() { return 0; }
+VITimeline::Stats VITimeline::getStats() { return {}; }
+void VITimeline::setRecording(bool) {}
+bool VITimeline::isRecording() { return false; }
+VITimeline::Histogram VITimeline::getHistogram() { return {}; }
+void VITimeline::logRecording(const char*) {}
+
+int main(int argc, char** argv)
+{
+  std::string demo = "vi";
+  std::string prefix = "viScanout";
+  int frames = 1;
+  bool beamRacing = false;
+  double factor = 0;
+  for(int i=1; i<argc; ++i) {
+    std::string arg{argv[i]};
+    if(arg == "-d" && i+1 < argc)demo = argv[++i];
+    else if(arg == "-b")beamRacing = true;
+    else if(arg == "-n" && i+1 < argc)frames = atoi(argv[++i]);
+    else if(arg == "-o" && i+1 < argc)prefix = argv[++i];
+    else if(arg == "-f" && i+1 < argc)factor = atof(argv[++i]);
+    else {
+      fprintf(stderr, "Usage: %s [-d vi|pong] [-b] [-n frames] [-o prefix] [-f factor]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  meter.init();
+  bool hasPerf = meter.perfFd >= 0;
+  if(factor <= 0)factor = hasPerf ? CYCLES_PER_HOST_INSTR : CYCLES_PER_HOST_NS;
+  printf("VR4300 cycles estimated as %.2f per host %s, budget per line: %.0f cycles\n",
+    factor, hasPerf ? "instruction" : "ns (no perf counters)", LINE_CYCLES
+  );
+
+  void (*demoInit)(){};
+  void (*demoDraw)(){};
+  void (*demoDrawBand)(uint32_t, uint32_t){};
+  if(demo == "vi") { demoInit = Demo::VI::init; demoDraw = Demo::VI::draw; }
+  else if(demo == "pong") { demoInit = Demo::VIPong::init; demoDraw = Demo::VIPong::draw; demoDrawBand = Demo::VIPong::drawBand; }
+  else {
+    fprintf(stderr, "Unknown demo '%s'\n", demo.c_str());
+    return 2;
+  }
+  if(beamRacing && !demoDrawBand) {
+    fprintf(stderr, "Demo '%s' has no beam-racing mode\n", demo.c_str());
+    return 2;
+  }
+
+  static RDPSim sim{HostShim::rdram, HostShim::RDRAM_SIZE};
+  HostShim::dpHandler = [](uint32_t start, uint32_t end) {
+    bool measured = meter.active;
+    if(measured)meter.pause();
+    sim.run((uint64_t*)(HostShim::rdram + start), (end - start) / 8);
+    if(measured)meter.resume();
+  };
+
+  *VI_X_SCALE = DEFAULT_X_SCALE;
+  *VI_H_VIDEO = DEFAULT_H_VIDEO;
+  state.fb = &fb;
+  state.frame = 3; // the demos skip the first frames after a switch
+  demoInit();
+  state.beamRacing = beamRacing;
+
+  printf("%-6s %6s %8s %12s %12s %8s\n", "Frame", "Lines", "Writes", "Host us", "Cycles/line", "%Line");
+  for(int f=0; f<frames; ++f)
+  {
+    ++state.frame;
+    state.time += 0.025f;
+    state.timeInt += 50;
+    if(beamRacing) {
+      // the bands fill the schedule of the frame itself, timed from the start of the frame
+      VITimeline::begin();
+      demoDraw();
+      for(uint32_t y=0; y<SCREEN_HEIGHT; y+=BEAM_BAND_HEIGHT)demoDrawBand(y, y + BEAM_BAND_HEIGHT);
+      VITimeline::submit();
+    } else {
+      demoDraw();
+      TaskQueue::flush(); // e.g. the VI table, which main builds while waiting for the next framebuffer
+    }
+
+    uint32_t lines = 0;
+    for(size_t i=0; i<schedule.size(); ++i) {
+      lines += i == 0 || schedule[i].line != schedule[i-1].line;
+    }
+    double cyclesPerLine = lines ? buildUnits * factor / lines : 0;
+    printf("%-6d %6u %8zu %12.2f %12.1f %8.2f\n", f, lines, schedule.size(),
+      buildNs / 1000.0, cyclesPerLine, cyclesPerLine * 100.0 / LINE_CYCLES
+    );
+
+    char suffix[16]{};
+    if(frames > 1)snprintf(suffix, sizeof(suffix), "_%03d", f);
+    writePNG(prefix + suffix + ".png", scanOut());
+  }
+
+  auto &stats = sim.getStats();
+  if(stats.unsupported) {
+    printf("Note: %u RDP commands are not modelled (e.g. text), see rdpSim.h\n", stats.unsupported);
+  }
+  return 0;
+}
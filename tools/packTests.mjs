@@ -0,0 +1,91 @@
+/**
+* @copyright 2025 - Max Bebök
+* @license MIT
+*/
+import fs from 'fs';
+import path from 'path';
+
+/**
+ * Packs all test references (*.test, RGBA16 big-endian) into a single indexed file.
+ * Layout (all values big-endian):
+ *   Header: 'R64T' | u16 version | u16 entryCount | u32 pixelCount | u32 reserved
+ *   Index : entryCount x {u32 id, u32 offset, u32 size}, sorted by id
+ *   Data  : RLE stream per entry, in 16bit words:
+ *           0x8000 | (n-1) followed by one value  -> value repeated n times
+ *           (n-1)          followed by n values   -> literal values
+ * Usage: node packTests.mjs <out.pack> <file.test>...
+ */
+const PACK_VERSION = 1;
+const HEADER_SIZE = 16;
+const INDEX_ENTRY_SIZE = 12;
+const MAX_COUNT = 0x8000;
+const MIN_RUN = 3; // shorter runs are cheaper as literals
+
+const outPath = process.argv[2];
+const inPaths = process.argv.slice(3);
+
+const encodeRLE = (words) => {
+  const out = [];
+  let litStart = -1;
+
+  const flushLiteral = (end) => {
+    while(litStart >= 0 && litStart < end) {
+      const count = Math.min(end - litStart, MAX_COUNT);
+      out.push(count - 1);
+      for(let i=0; i<count; ++i)out.push(words[litStart + i]);
+      litStart += count;
+    }
+    litStart = -1;
+  };
+
+  let i = 0;
+  while(i < words.length) {
+    let j = i;
+    while(j < words.length && words[j] === words[i] && (j - i) < MAX_COUNT)++j;
+
+    if((j - i) >= MIN_RUN) {
+      flushLiteral(i);
+      out.push(0x8000 | (j - i - 1), words[i]);
+      i = j;
+    } else {
+      if(litStart < 0)litStart = i;
+      ++i;
+    }
+  }
+  flushLiteral(words.length);
+
+  const buff = Buffer.alloc(out.length * 2);
+  out.forEach((w, idx) => buff.writeUInt16BE(w, idx * 2));
+  return buff;
+};
+
+const entries = inPaths.map(p => {
+  const id = parseInt(path.basename(p, '.test'), 16);
+  const raw = fs.readFileSync(p);
+  const words = [];
+  for(let i=0; i<raw.length; i+=2)words.push(raw.readUInt16BE(i));
+  return {id, pixelCount: words.length, data: encodeRLE(words)};
+}).sort((a, b) => a.id - b.id);
+
+if(entries.length === 0 || entries.some(e => e.pixelCount !== entries[0].pixelCount)) {
+  console.error("All references must exist and have the same size");
+  process.exit(1);
+}
+
+const header = Buffer.alloc(HEADER_SIZE + entries.length * INDEX_ENTRY_SIZE);
+header.write('R64T', 0, 'ascii');
+header.writeUInt16BE(PACK_VERSION, 4);
+header.writeUInt16BE(entries.length, 6);
+header.writeUInt32BE(entries[0].pixelCount, 8);
+
+let offset = header.length;
+entries.forEach((e, i) => {
+  const pos = HEADER_SIZE + i * INDEX_ENTRY_SIZE;
+  header.writeUInt32BE(e.id >>> 0, pos);
+  header.writeUInt32BE(offset, pos + 4);
+  header.writeUInt32BE(e.data.length, pos + 8);
+  offset += e.data.length;
+});
+
+fs.writeFileSync(outPath, Buffer.concat([header, ...entries.map(e => e.data)]));
+console.log(`Packed ${entries.length} references into ${outPath} (${offset} bytes)`);